@@ -0,0 +1,209 @@
+#include "indexed_view.hpp"
+#include "indexed_view_segmented.hpp"
+#include "indexed_view_progress.hpp"
+#include "indexed_view_extrema.hpp"
+#include "indexed_view_where.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <stddef.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// Prevent the compiler from optimizing away a computed value
+template <typename T> void do_not_optimize(T const &value) {
+#ifdef _MSC_VER
+    static void const *volatile sink;
+    sink= &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+/// Run the supplied function repeatedly over a fresh buffer, and report the
+/// best time per element
+template <typename Func>
+double time_per_element(size_t count, unsigned repeats, Func func) {
+    double best= 0;
+    for(unsigned i= 0; i < repeats; ++i) {
+        auto const start= std::chrono::steady_clock::now();
+        func();
+        auto const finish= std::chrono::steady_clock::now();
+        double const ns=
+            std::chrono::duration<double, std::nano>(finish - start).count() /
+            count;
+        if(!i || (ns < best))
+            best= ns;
+    }
+    return best;
+}
+
+void report(std::string const &name, double ns_per_element) {
+    std::cout << name << ": " << ns_per_element << " ns/element\n";
+}
+
+void bench_random_access_multiply_by_index() {
+    size_t const count= 1 << 20;
+    unsigned const repeats= 50;
+    std::vector<int> v(count, 3);
+
+    report("raw index loop", time_per_element(count, repeats, [&] {
+               for(size_t i= 0; i < v.size(); ++i) {
+                   v[i]*= static_cast<int>(i);
+               }
+               do_not_optimize(v);
+           }));
+
+    report("indexed_view loop", time_per_element(count, repeats, [&] {
+               for(auto x : jss::indexed_view(v)) {
+                   x.value*= static_cast<int>(x.index);
+               }
+               do_not_optimize(v);
+           }));
+}
+
+/// The deque from test_can_index_iterator_pairs, repeated to fill a large
+/// deque
+std::deque<int> make_deque_fixture(size_t count) {
+    int const pattern[]= {1, 45, 67, 98, 123, -45};
+    std::deque<int> d;
+    for(size_t i= 0; i < count; ++i) {
+        d.push_back(pattern[i % 6]);
+    }
+    return d;
+}
+
+void bench_deque_multiply_by_index() {
+    size_t const count= 1 << 20;
+    unsigned const repeats= 50;
+    std::deque<int> d= make_deque_fixture(count);
+
+    report("deque indexed_view loop", time_per_element(count, repeats, [&] {
+               for(auto x : jss::indexed_view(d)) {
+                   x.value*= static_cast<int>(x.index);
+               }
+               do_not_optimize(d);
+           }));
+
+    report("deque indexed_for_each", time_per_element(count, repeats, [&] {
+               jss::indexed_for_each(jss::indexed_view(d), [](auto x) {
+                   x.value*= static_cast<int>(x.index);
+               });
+               do_not_optimize(d);
+           }));
+
+    report("deque indexed_view sum", time_per_element(count, repeats, [&] {
+               long sum= 0;
+               for(auto x : jss::indexed_view(d)) {
+                   sum+= x.value * static_cast<long>(x.index);
+               }
+               do_not_optimize(sum);
+           }));
+
+    report("deque indexed_accumulate", time_per_element(count, repeats, [&] {
+               long const sum= jss::indexed_accumulate(
+                   jss::indexed_view(d), 0L, [](long total, auto x) {
+                       return total + x.value * static_cast<long>(x.index);
+                   });
+               do_not_optimize(sum);
+           }));
+}
+
+void bench_observed_multiply_by_index() {
+    size_t const count= 1 << 20;
+    unsigned const repeats= 50;
+    std::vector<int> v(count, 3);
+    jss::indexed_progress progress;
+
+    report("observed_indexed_view loop", time_per_element(count, repeats, [&] {
+               for(auto x : jss::observed_indexed_view(v, progress)) {
+                   x.value*= static_cast<int>(x.index);
+               }
+               do_not_optimize(v);
+           }));
+
+    report(
+        "disabled observed_indexed_view loop",
+        time_per_element(count, repeats, [&] {
+            for(auto x : jss::observed_indexed_view<0>(v, progress)) {
+                x.value*= static_cast<int>(x.index);
+            }
+            do_not_optimize(v);
+        }));
+}
+
+void bench_argmax_and_top_k() {
+    size_t const count= 1 << 20;
+    unsigned const repeats= 50;
+    std::vector<float> v(count);
+    unsigned state= 1;
+    for(auto &x : v) {
+        state= state * 1664525u + 1013904223u;
+        x= static_cast<float>(state >> 8);
+    }
+
+    report("raw argmax loop", time_per_element(count, repeats, [&] {
+               size_t best= 0;
+               for(size_t i= 1; i < v.size(); ++i) {
+                   if(v[best] < v[i])
+                       best= i;
+               }
+               do_not_optimize(best);
+           }));
+
+    report("argmax", time_per_element(count, repeats, [&] {
+               auto const best= jss::argmax(jss::indexed_view(v));
+               do_not_optimize(best);
+           }));
+
+    report("top_k_indices(10)", time_per_element(count, repeats, [&] {
+               auto const top= jss::top_k_indices(jss::indexed_view(v), 10);
+               do_not_optimize(top);
+           }));
+}
+
+void bench_indices_where() {
+    size_t const count= 1 << 20;
+    unsigned const repeats= 50;
+    std::vector<float> v(count);
+    unsigned state= 1;
+    for(auto &x : v) {
+        state= state * 1664525u + 1013904223u;
+        x= static_cast<float>(state >> 8) / 16777216.0f;
+    }
+    std::vector<size_t> indices(count);
+
+    for(float const density : {0.01f, 0.5f}) {
+        std::string const suffix= " (" + std::to_string(density) + ")";
+        report(
+            "push_back loop" + suffix, time_per_element(count, repeats, [&] {
+                std::vector<size_t> matches;
+                for(auto x : jss::indexed_view(v)) {
+                    if(x.value < density)
+                        matches.push_back(x.index);
+                }
+                do_not_optimize(matches);
+            }));
+
+        report(
+            "indices_where" + suffix, time_per_element(count, repeats, [&] {
+                size_t *const end= jss::indices_where(
+                    jss::indexed_view(v),
+                    [density](auto x) { return x.value < density; },
+                    indices.data());
+                do_not_optimize(end);
+            }));
+    }
+}
+
+int main() {
+    bench_random_access_multiply_by_index();
+    bench_deque_multiply_by_index();
+    bench_observed_multiply_by_index();
+    bench_argmax_and_top_k();
+    bench_indices_where();
+}
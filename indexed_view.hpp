@@ -1,16 +1,625 @@
 #ifndef JSS_INDEXED_VIEW_HPP
 #define JSS_INDEXED_VIEW_HPP
+#include <iosfwd>
 #include <iterator>
+#include <memory>
 #include <type_traits>
+#include <vector>
 #include <stddef.h>
 #include <stdlib.h>
 
+/// The SIMD code paths of the indexed view headers use SSE2 where it is
+/// available. Define JSS_INDEXED_VIEW_HAS_SSE2 before including the headers
+/// to force it on.
+#ifndef JSS_INDEXED_VIEW_HAS_SSE2
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define JSS_INDEXED_VIEW_HAS_SSE2
+#endif
+#endif
+
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace jss {
+    /// Tag type for requesting that a splittable range is split in half
+    struct split {};
+
+    /// Tag type for requesting that a splittable range is split in
+    /// proportion: the first part gets left()/(left()+right()) of the elements
+    class proportional_split {
+    public:
+        /// Construct a tag for splitting in the ratio left_:right_
+        proportional_split(size_t left_, size_t right_) noexcept :
+            left_units(left_), right_units(right_) {}
+
+        /// The proportion for the first part
+        size_t left() const noexcept {
+            return left_units;
+        }
+        /// The proportion for the second part
+        size_t right() const noexcept {
+            return right_units;
+        }
+
+    private:
+        /// The proportion for the first part
+        size_t left_units;
+        /// The proportion for the second part
+        size_t right_units;
+    };
+
+    /// A checkpoint for resuming iteration over an indexed view. index is
+    /// the index of the next element to process. offset is the position of
+    /// that element in the source for sources that need one, such as the
+    /// byte offset in a text buffer, and zero otherwise. Checkpoints can be
+    /// written to and read from streams, so they can be stored and used to
+    /// resume iteration in a later run.
+    struct indexed_checkpoint {
+        /// The index of the next element
+        size_t index;
+        /// The source-specific position of the next element
+        unsigned long long offset;
+    };
+
+    /// Write a checkpoint to a stream as two space-separated numbers
+    template <typename CharT, typename Traits>
+    std::basic_ostream<CharT, Traits> &operator<<(
+        std::basic_ostream<CharT, Traits> &os,
+        indexed_checkpoint const &checkpoint) {
+        return os << checkpoint.index << ' ' << checkpoint.offset;
+    }
+
+    /// Read a checkpoint written with operator<<
+    template <typename CharT, typename Traits>
+    std::basic_istream<CharT, Traits> &operator>>(
+        std::basic_istream<CharT, Traits> &is,
+        indexed_checkpoint &checkpoint) {
+        return is >> checkpoint.index >> checkpoint.offset;
+    }
+
+    /// A sparse index of positions in an indexed view over a forward range,
+    /// holding a copy of the view iterator for every stride-th element, so
+    /// resume(checkpoint,skip_index) can advance from the nearest recorded
+    /// position rather than from the start of the range. Positions are
+    /// recorded by passing iterators to record(), such as once for each
+    /// element of a loop, and by resume() as it advances. The recorded
+    /// iterators refer to the view, so the skip index cannot be serialized:
+    /// it can only be used with that view, in the same process, while the
+    /// range is unchanged. After a restart, resuming a view over a forward
+    /// range advances from the start of the range.
+    template <typename Iterator> class indexed_skip_index {
+    public:
+        /// The default number of elements between recorded positions
+        static constexpr size_t default_stride= 1024;
+
+        /// Construct an empty skip index that records the position of every
+        /// stride_-th element
+        explicit indexed_skip_index(size_t stride_= default_stride) :
+            stride(stride_ ? stride_ : 1), next_index(0) {}
+
+        /// Record the position of an iterator that refers to an element, if
+        /// it is the next position to be recorded. Positions are recorded in
+        /// order, so for other elements this is a single comparison.
+        void record(Iterator const &it) {
+            if(it.checkpoint().index == next_index) {
+                positions.push_back(it);
+                next_index+= stride;
+            }
+        }
+
+        /// Get the recorded position with the largest index that is not
+        /// greater than index, or nullptr if no positions are recorded
+        Iterator const *nearest(size_t index) const noexcept {
+            if(positions.empty())
+                return nullptr;
+            size_t const entry= index / stride;
+            return &positions
+                [entry < positions.size() ? entry : positions.size() - 1];
+        }
+
+        /// The number of elements between recorded positions
+        size_t get_stride() const noexcept {
+            return stride;
+        }
+
+        /// The number of recorded positions
+        size_t size() const noexcept {
+            return positions.size();
+        }
+
+    private:
+        /// The number of elements between recorded positions
+        size_t stride;
+        /// The index of the next position to record
+        size_t next_index;
+        /// The recorded positions: entry k has index k*stride
+        std::vector<Iterator> positions;
+    };
+
+    /// Traits for iterators over elements stored contiguously in memory.
+    /// The primary template is for iterators that are not known to be
+    /// contiguous. Specializations for contiguous iterators set
+    /// is_contiguous to true, define element_type, and provide a static
+    /// data(it) function that returns a pointer to *it, which is valid for
+    /// any iterator in the range, including the end iterator.
+    template <typename Iterator> struct contiguous_iterator_traits {
+        /// The iterator is not known to be contiguous
+        static constexpr bool is_contiguous= false;
+    };
+
+    /// Pointers are contiguous iterators
+    template <typename T> struct contiguous_iterator_traits<T *> {
+        /// The iterator is contiguous
+        static constexpr bool is_contiguous= true;
+        /// The type of the elements
+        using element_type= T;
+
+        /// A pointer to the element
+        static T *data(T *it) noexcept {
+            return it;
+        }
+    };
+
+#ifdef __GLIBCXX__
+    /// The iterators for std::vector, std::array and std::basic_string in
+    /// libstdc++ wrap pointers
+    template <typename T, typename Container>
+    struct contiguous_iterator_traits<
+        __gnu_cxx::__normal_iterator<T *, Container>> {
+        /// The iterator is contiguous
+        static constexpr bool is_contiguous= true;
+        /// The type of the elements
+        using element_type= T;
+
+        /// A pointer to the element
+        static T *
+        data(__gnu_cxx::__normal_iterator<T *, Container> const &it) noexcept {
+            return it.base();
+        }
+    };
+#endif
+
+#ifdef _LIBCPP_VERSION
+    /// The iterators for std::vector and std::basic_string in libc++ wrap
+    /// pointers
+    template <typename T>
+    struct contiguous_iterator_traits<std::__wrap_iter<T *>> {
+        /// The iterator is contiguous
+        static constexpr bool is_contiguous= true;
+        /// The type of the elements
+        using element_type= T;
+
+        /// A pointer to the element
+        static T *data(std::__wrap_iter<T *> const &it) noexcept {
+            return it.base();
+        }
+    };
+#endif
+
     namespace detail {
+        /// Input iterators that return their values by value need a proxy for
+        /// ->
+        template <typename ValueType> struct arrow_proxy {
+            /// Our proxy operator->
+            ValueType *operator->() noexcept {
+                return &value;
+            }
+
+            /// The pointed-to value
+            ValueType value;
+        };
+
+        /// Proxy for handling *x++ on input iterators
+        template <typename ValueType> struct postinc_return {
+            /// The pointed-to value
+            ValueType value;
+
+            /// Our proxy operator*
+            const ValueType operator*() noexcept(
+                std::is_nothrow_move_constructible<ValueType>::value) {
+                return std::move(value);
+            }
+        };
+
+        /// Helper for detecting well-formed types
+        template <typename...> struct make_void { using type= void; };
+
+        /// Is the supplied type a random-access iterator?
+        template <typename Iterator, typename= void>
+        struct is_random_access_iterator : std::false_type {};
+
+        /// Is the supplied type a random-access iterator?
+        template <typename Iterator>
+        struct is_random_access_iterator<
+            Iterator, typename make_void<typename std::iterator_traits<
+                          Iterator>::iterator_category>::type>
+            : std::is_base_of<
+                  std::random_access_iterator_tag,
+                  typename std::iterator_traits<Iterator>::iterator_category> {
+        };
+
+        /// Is the supplied type a forward iterator, so copies can be used to
+        /// revisit elements?
+        template <typename Iterator, typename= void>
+        struct is_forward_iterator : std::false_type {};
+
+        /// Is the supplied type a forward iterator, so copies can be used to
+        /// revisit elements?
+        template <typename Iterator>
+        struct is_forward_iterator<
+            Iterator, typename make_void<typename std::iterator_traits<
+                          Iterator>::iterator_category>::type>
+            : std::is_base_of<
+                  std::forward_iterator_tag,
+                  typename std::iterator_traits<Iterator>::iterator_category> {
+        };
+
+        /// Advance from the position recorded in skip_index that is nearest
+        /// to index, or from first if there is none, until the iterator
+        /// reaches the element with that index or last, recording the
+        /// positions passed on the way
+        template <typename Iterator>
+        Iterator resume_from_skip_index(
+            Iterator first, Iterator const &last, size_t index,
+            indexed_skip_index<Iterator> &skip_index) {
+            if(Iterator const *nearest= skip_index.nearest(index))
+                first= *nearest;
+            for(; first != last; ++first) {
+                skip_index.record(first);
+                if(first.checkpoint().index == index)
+                    break;
+            }
+            return first;
+        }
+
+        /// Is the range given by the iterator/sentinel pair a random-access
+        /// range, so we can compute its size up front?
+        template <typename UnderlyingIterator, typename UnderlyingSentinel>
+        struct is_random_access_range
+            : std::integral_constant<
+                  bool,
+                  std::is_same<UnderlyingIterator, UnderlyingSentinel>::value &&
+                      is_random_access_iterator<UnderlyingIterator>::value> {};
+
+        template <
+            typename UnderlyingIterator, typename UnderlyingSentinel,
+            bool RandomAccess= is_random_access_range<
+                UnderlyingIterator, UnderlyingSentinel>::value>
+        class indexed_view_type;
+
+        template <typename UnderlyingIterator> class counted_indexed_view_type;
+
+        struct counted_iterator_access;
+
+        /// An iterator for an indexed view where termination is determined by
+        /// the index alone, so the underlying iterator is never compared with
+        /// anything. Used for counted views, and for views over random-access
+        /// ranges where the size is known up front, so the compiler can
+        /// compute the trip count of a loop
+        template <typename UnderlyingIterator> class counted_indexed_iterator {
+        private:
+            /// Is the iterator nothrow copy constructible?
+            static constexpr bool nothrow_copy_iterators=
+                std::is_nothrow_copy_constructible<UnderlyingIterator>::value;
+            /// Is incrementing an iterator nothrow?
+            static constexpr bool nothrow_iterator_increment=
+                noexcept(++std::declval<UnderlyingIterator &>());
+
+            /// The type of dereferencing an underlying iterator
+            using underlying_value_type=
+                decltype(*std::declval<UnderlyingIterator &>());
+            /// Is dereferencing an iterator nothrow?
+            static constexpr bool nothrow_deref=
+                noexcept(*std::declval<UnderlyingIterator &>());
+
+        public:
+            /// The value_type is an index/value pair
+            struct value_type {
+                size_t index;
+                underlying_value_type value;
+            };
+
+        private:
+            /// It's an input iterator, so we need a proxy for ->
+            using arrow_proxy= detail::arrow_proxy<value_type>;
+            /// Proxy for handling *x++
+            using postinc_return= detail::postinc_return<value_type>;
+
+            /// Is the underlying iterator a random-access iterator?
+            static constexpr bool random_access=
+                is_random_access_iterator<UnderlyingIterator>::value;
+
+        public:
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs: we are random-access if the
+            /// underlying iterator is, otherwise just an input iterator. The
+            /// reference is a const proxy value rather than a true
+            /// reference, so random-access iterators support traversal
+            /// (OpenMP loops, splitting, and non-modifying algorithms such as
+            /// std::find_if or std::partition_point), but algorithms that
+            /// assign or swap elements through the iterator, such as
+            /// std::sort or std::reverse, do not compile. Elements are
+            /// modified through the value member instead.
+            using iterator_category= typename std::conditional<
+                random_access, std::random_access_iterator_tag,
+                std::input_iterator_tag>::type;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= typename std::
+                conditional<random_access, ptrdiff_t, void>::type;
+
+            /// Default constructor, as required for random-access iterators
+            counted_indexed_iterator() : index(0), source_iter() {}
+
+            /// Compare iterators for inequality. Only the indices are compared
+            friend bool operator!=(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index != rhs.index;
+            }
+
+            /// Compare iterators for equality. Only the indices are compared
+            friend bool operator==(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index == rhs.index;
+            }
+
+            /// Dereference the iterator
+            const value_type operator*() const noexcept(
+                nothrow_deref &&
+                    std::is_nothrow_move_constructible<value_type>::value) {
+                return value_type{index, *source_iter};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const noexcept(
+                nothrow_deref &&
+                    std::is_nothrow_move_constructible<value_type>::value) {
+                return arrow_proxy{value_type{index, *source_iter}};
+            }
+
+            /// Get a checkpoint for resuming iteration at this element
+            indexed_checkpoint checkpoint() const noexcept {
+                return indexed_checkpoint{index, 0};
+            }
+
+            /// Pre-increment
+            counted_indexed_iterator &
+            operator++() noexcept(nothrow_iterator_increment) {
+                ++source_iter;
+                ++index;
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) noexcept(
+                nothrow_iterator_increment &&nothrow_deref &&
+                    std::is_nothrow_move_constructible<value_type>::value) {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+            /// The remaining operations are only valid if the underlying
+            /// iterator is a random-access iterator. Comparisons and
+            /// differences only use the index, so the trip count of a loop is
+            /// a simple integer difference
+
+            /// Pre-decrement
+            counted_indexed_iterator &operator--() {
+                --source_iter;
+                --index;
+                return *this;
+            }
+
+            /// Post-decrement
+            counted_indexed_iterator operator--(int) {
+                counted_indexed_iterator temp(*this);
+                --*this;
+                return temp;
+            }
+
+            /// Advance the iterator by the specified amount
+            counted_indexed_iterator &operator+=(ptrdiff_t offset) {
+                source_iter+= offset;
+                index+= offset;
+                return *this;
+            }
+
+            /// Move the iterator back by the specified amount
+            counted_indexed_iterator &operator-=(ptrdiff_t offset) {
+                source_iter-= offset;
+                index-= offset;
+                return *this;
+            }
+
+            /// Get an iterator advanced by the specified amount
+            friend counted_indexed_iterator operator+(
+                counted_indexed_iterator iter, ptrdiff_t offset) {
+                iter+= offset;
+                return iter;
+            }
+
+            /// Get an iterator advanced by the specified amount
+            friend counted_indexed_iterator operator+(
+                ptrdiff_t offset, counted_indexed_iterator iter) {
+                iter+= offset;
+                return iter;
+            }
+
+            /// Get an iterator moved back by the specified amount
+            friend counted_indexed_iterator operator-(
+                counted_indexed_iterator iter, ptrdiff_t offset) {
+                iter-= offset;
+                return iter;
+            }
+
+            /// The distance between two iterators
+            friend ptrdiff_t operator-(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return static_cast<ptrdiff_t>(lhs.index - rhs.index);
+            }
+
+            /// Dereference the iterator at the specified offset
+            const value_type operator[](ptrdiff_t offset) const {
+                return value_type{index + offset, source_iter[offset]};
+            }
+
+            /// Ordering of iterators
+            friend bool operator<(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index < rhs.index;
+            }
+
+            /// Ordering of iterators
+            friend bool operator>(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index > rhs.index;
+            }
+
+            /// Ordering of iterators
+            friend bool operator<=(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index <= rhs.index;
+            }
+
+            /// Ordering of iterators
+            friend bool operator>=(
+                counted_indexed_iterator const &lhs,
+                counted_indexed_iterator const &rhs) noexcept {
+                return lhs.index >= rhs.index;
+            }
+
+        private:
+            template <typename, typename, bool> friend class indexed_view_type;
+            friend class counted_indexed_view_type<UnderlyingIterator>;
+            friend struct counted_iterator_access;
+
+            /// Construct from an underlying iterator and an index
+            counted_indexed_iterator(
+                size_t index_,
+                UnderlyingIterator const
+                    &source_iter_) noexcept(nothrow_copy_iterators) :
+                index(index_),
+                source_iter(source_iter_) {}
+
+            /// The stored index
+            size_t index;
+            /// The underlying iterator. This is never dereferenced or
+            /// incremented for an end iterator
+            mutable UnderlyingIterator source_iter;
+        };
+
+        /// Access to the internals of counted_indexed_iterator for
+        /// algorithms that work directly on the underlying iterators
+        struct counted_iterator_access {
+            /// The index of the iterator
+            template <typename UnderlyingIterator>
+            static size_t
+            index(counted_indexed_iterator<UnderlyingIterator> const
+                      &it) noexcept {
+                return it.index;
+            }
+
+            /// The underlying iterator
+            template <typename UnderlyingIterator>
+            static UnderlyingIterator const &
+            source(counted_indexed_iterator<UnderlyingIterator> const
+                       &it) noexcept {
+                return it.source_iter;
+            }
+        };
+
+        /// Is the iterator a contiguous iterator over arithmetic values?
+        template <
+            typename UnderlyingIterator,
+            bool Contiguous= contiguous_iterator_traits<
+                UnderlyingIterator>::is_contiguous>
+        struct has_contiguous_arithmetic_values : std::false_type {};
+
+        /// Is the iterator a contiguous iterator over arithmetic values?
+        template <typename UnderlyingIterator>
+        struct has_contiguous_arithmetic_values<UnderlyingIterator, true>
+            : std::is_arithmetic<typename contiguous_iterator_traits<
+                  UnderlyingIterator>::element_type> {};
+
+        /// Is the iterator for a view a counted_indexed_iterator over a
+        /// contiguous range of arithmetic values?
+        template <typename Iterator>
+        struct is_contiguous_arithmetic_iterator : std::false_type {};
+
+        /// Is the iterator for a view a counted_indexed_iterator over a
+        /// contiguous range of arithmetic values?
+        template <typename UnderlyingIterator>
+        struct is_contiguous_arithmetic_iterator<
+            counted_indexed_iterator<UnderlyingIterator>>
+            : has_contiguous_arithmetic_values<UnderlyingIterator> {};
+
+        /// The contiguous values in the range [first,last) of a view, and
+        /// the index of the first
+        template <typename T> struct contiguous_values {
+            /// The first value
+            T *data;
+            /// The number of values
+            size_t size;
+            /// The index of the first value
+            size_t base_index;
+        };
+
+        /// Get the contiguous values in the range [first,last) of a view,
+        /// where is_contiguous_arithmetic_iterator is true for the iterators
+        template <typename UnderlyingIterator>
+        contiguous_values<typename contiguous_iterator_traits<
+            UnderlyingIterator>::element_type>
+        get_contiguous_values(
+            counted_indexed_iterator<UnderlyingIterator> const &first,
+            counted_indexed_iterator<UnderlyingIterator> const
+                &last) noexcept {
+            size_t const base_index= counted_iterator_access::index(first);
+            return {
+                contiguous_iterator_traits<UnderlyingIterator>::data(
+                    counted_iterator_access::source(first)),
+                counted_iterator_access::index(last) - base_index, base_index};
+        }
+
+        /// An element tracker that records nothing, for the sequential
+        /// algorithms, which let exceptions propagate unchanged
+        struct no_element_tracker {
+            /// Note that the element with the specified index is being
+            /// processed
+            void reached(size_t) const noexcept {}
+        };
+
+        /// An element tracker that records the index of the element being
+        /// processed, so the parallel algorithms can report the element for
+        /// which an exception was thrown
+        struct element_tracker {
+            /// The index of the element being processed
+            size_t &current;
+
+            /// Note that the element with the specified index is being
+            /// processed
+            void reached(size_t index) const noexcept {
+                current= index;
+            }
+        };
+
         /// A type that encapsulates an indexed view over an underlying range
         /// So the value_type is a struct holding an index and the value of the
         /// underlying range
-        template <typename UnderlyingIterator, typename UnderlyingSentinel>
+        template <
+            typename UnderlyingIterator, typename UnderlyingSentinel,
+            bool RandomAccess>
         class indexed_view_type {
         private:
             /// Special index marker for the sentinel
@@ -61,27 +670,11 @@ namespace jss {
             /// The iterator for our range
             class iterator {
                 /// It's an input iterator, so we need a proxy for ->
-                struct arrow_proxy {
-                    /// Our proxy operator->
-                    value_type *operator->() noexcept {
-                        return &value;
-                    }
-
-                    /// The pointed-to value
-                    value_type value;
-                };
-
+                using arrow_proxy= detail::arrow_proxy<
+                    typename indexed_view_type::value_type>;
                 /// Proxy for handling *x++
-                struct postinc_return {
-                    /// The pointed-to value
-                    value_type value;
-
-                    /// Our proxy operator*
-                    const value_type operator*() noexcept(
-                        std::is_nothrow_move_constructible<value_type>::value) {
-                        return std::move(value);
-                    }
-                };
+                using postinc_return= detail::postinc_return<
+                    typename indexed_view_type::value_type>;
 
             public:
                 /// Required iterator typedefs
@@ -140,6 +733,12 @@ namespace jss {
                         value_type{index, *get_source_iterator()}};
                 }
 
+                /// Get a checkpoint for resuming iteration at this element.
+                /// Not valid for the end iterator
+                indexed_checkpoint checkpoint() const noexcept {
+                    return indexed_checkpoint{index, 0};
+                }
+
                 /// Pre-increment
                 iterator &operator++() noexcept(nothrow_iterator_increment) {
                     ++get_source_iterator();
@@ -291,6 +890,36 @@ namespace jss {
                 return iterator(source_end);
             }
 
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, or the end iterator if there is no such element.
+            /// The range is not random-access, so this advances from the
+            /// start of the range one element at a time.
+            iterator resume(indexed_checkpoint const &checkpoint) {
+                iterator result= begin();
+                iterator const last= end();
+                while((result.index != checkpoint.index) && (result != last)) {
+                    ++result;
+                }
+                return result;
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, or the end iterator if there is no such element,
+            /// advancing from the nearest position recorded in skip_index
+            /// rather than from the start, so at most get_stride() elements
+            /// are visited once the positions have been recorded. Positions
+            /// passed on the way are recorded. The range must be a forward
+            /// range.
+            iterator resume(
+                indexed_checkpoint const &checkpoint,
+                indexed_skip_index<iterator> &skip_index) {
+                static_assert(
+                    is_forward_iterator<UnderlyingIterator>::value,
+                    "Skip indexes require forward iterators");
+                return resume_from_skip_index(
+                    begin(), end(), checkpoint.index, skip_index);
+            }
+
         private:
             /// The start of the underlying range
             UnderlyingIterator source_begin;
@@ -298,53 +927,474 @@ namespace jss {
             UnderlyingSentinel source_end;
         };
 
-        /// A class to hold a copy of a source range, in order to keep it alive
-        template <typename Range> class range_holder {
+        /// Does the supplied split tag request a proportional split, by
+        /// providing left() and right()?
+        template <typename Split, typename= void>
+        struct is_proportional_split : std::false_type {};
+
+        /// Does the supplied split tag request a proportional split, by
+        /// providing left() and right()?
+        template <typename Split>
+        struct is_proportional_split<
+            Split, typename make_void<
+                       decltype(std::declval<Split const &>().left()),
+                       decltype(std::declval<Split const &>().right())>::type>
+            : std::true_type {};
+
+        /// Is the type an iterator?
+        template <typename Type, typename= void>
+        struct is_iterator : std::false_type {};
+
+        /// Is the type an iterator?
+        template <typename Type>
+        struct is_iterator<
+            Type, typename make_void<typename std::iterator_traits<
+                      Type>::iterator_category>::type> : std::true_type {};
+
+        /// Can the type be used as a split tag? Split tags are class types
+        /// that are either empty, like jss::split, or provide left() and
+        /// right(), like jss::proportional_split, and are not iterators, so
+        /// passing some other value to a splitting constructor by mistake
+        /// does not compile
+        template <typename Split>
+        struct is_split_tag
+            : std::integral_constant<
+                  bool, std::is_class<Split>::value &&
+                            (std::is_empty<Split>::value ||
+                             is_proportional_split<Split>::value) &&
+                            !is_iterator<Split>::value> {};
+
+        /// An indexed view over a random-access range. The size of the range
+        /// is computed up front, so the end test is a plain comparison of the
+        /// indices, and the compiler can compute the trip count of a loop.
+        ///
+        /// These views are also splittable ranges: they provide empty(),
+        /// is_divisible() and splitting constructors, so they can be divided
+        /// by recursive-bisection schedulers. Each part keeps the indices of
+        /// the corresponding elements of the original view.
+        template <typename UnderlyingIterator>
+        class indexed_view_type<UnderlyingIterator, UnderlyingIterator, true> {
         private:
-            /// The stored range
-            mutable Range source_range;
+            /// Is the underlying iterator nothrow move constructible?
+            static constexpr bool nothrow_move_iterators=
+                std::is_nothrow_move_constructible<UnderlyingIterator>::value;
+            /// Is the iterator nothrow copy constructible?
+            static constexpr bool nothrow_copy_iterators=
+                std::is_nothrow_copy_constructible<UnderlyingIterator>::value;
+            /// Is subtracting iterators nothrow?
+            static constexpr bool nothrow_iterator_difference=
+                noexcept(std::declval<UnderlyingIterator &>() -
+                         std::declval<UnderlyingIterator &>());
 
-        protected:
-            /// Move a source range into internal storage
-            range_holder(Range &source_) noexcept(
-                std::is_nothrow_move_constructible<Range>::value) :
-                source_range(std::move(source_)) {}
+        public:
+            /// Construct a range from an iterator pair
+            indexed_view_type(
+                UnderlyingIterator &&begin_,
+                UnderlyingIterator &&end_) noexcept(nothrow_move_iterators) :
+                source_begin(std::move(begin_)),
+                source_end(std::move(end_)), base_index(0) {}
+
+            /// Construct a range from an iterator pair, where the first
+            /// element has the specified index
+            indexed_view_type(
+                UnderlyingIterator &&begin_, UnderlyingIterator &&end_,
+                size_t base_index_) noexcept(nothrow_move_iterators) :
+                source_begin(std::move(begin_)),
+                source_end(std::move(end_)), base_index(base_index_) {}
+
+            /// Splitting constructor. Split other into two parts: other is
+            /// left with the first part, and the new view holds the
+            /// remainder. If the split tag provides left() and right() then
+            /// other is left with that proportion of the elements, otherwise
+            /// it is split in half. Any split tag type can be used, so this
+            /// works with the tag types of third-party schedulers.
+            template <
+                typename Split,
+                typename= typename std::enable_if<
+                    is_split_tag<Split>::value>::type>
+            indexed_view_type(indexed_view_type &other, Split const &split_) :
+                indexed_view_type(
+                    other,
+                    split_point(
+                        other.size(), split_,
+                        is_proportional_split<Split>()),
+                    0) {}
+
+            /// Splittable views can be split in proportion
+            static constexpr bool is_splittable_in_proportion= true;
 
-            /// Get the begin iterator for the stored range
-            auto get_source_begin() const
-                noexcept(noexcept(std::begin(std::declval<Range &>())))
-                    -> decltype(std::begin(this->source_range)) {
-                return std::begin(source_range);
+            /// The iterator for our range
+            using iterator= counted_indexed_iterator<UnderlyingIterator>;
+            /// The value_type of our range is an index/value pair
+            using value_type= typename iterator::value_type;
+
+            /// Get an iterator for the start of the range
+            iterator begin() noexcept(nothrow_copy_iterators) {
+                return iterator(base_index, source_begin);
             }
-            /// Get the end iterator for the stored range
-            auto get_source_end() const
-                noexcept(noexcept(std::end(std::declval<Range &>())))
-                    -> decltype(std::end(this->source_range)) {
-                return std::end(source_range);
+            /// Get an iterator for the end of the range, with the index set to
+            /// the size of the range after the start index
+            iterator end() noexcept(
+                nothrow_copy_iterators &&nothrow_iterator_difference) {
+                return iterator(base_index + size(), source_end);
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, in constant time. Indices before the start of the
+            /// range give begin(), and indices past the end give end().
+            iterator resume(indexed_checkpoint const &checkpoint) {
+                size_t const range_size= size();
+                size_t offset= checkpoint.index > base_index ?
+                                   checkpoint.index - base_index :
+                                   0;
+                if(offset > range_size)
+                    offset= range_size;
+                return iterator(
+                    base_index + offset,
+                    source_begin + static_cast<ptrdiff_t>(offset));
+            }
+
+            /// Resuming takes constant time, so the skip index is not needed,
+            /// and this is the same as resume(checkpoint)
+            iterator resume(
+                indexed_checkpoint const &checkpoint,
+                indexed_skip_index<iterator> &) {
+                return resume(checkpoint);
             }
+
+            /// The number of elements in the range
+            size_t size() const noexcept(nothrow_iterator_difference) {
+                return static_cast<size_t>(source_end - source_begin);
+            }
+
+            /// Is the range empty?
+            bool empty() const noexcept(nothrow_iterator_difference) {
+                return !size();
+            }
+
+            /// Can the range be split into two non-empty parts?
+            bool is_divisible() const noexcept(nothrow_iterator_difference) {
+                return size() > 1;
+            }
+
+        private:
+            /// Construct the second part of other, starting left_size
+            /// elements from the start, and truncate other to the first part
+            indexed_view_type(
+                indexed_view_type &other, size_t left_size, int) :
+                source_begin(
+                    other.source_begin + static_cast<ptrdiff_t>(left_size)),
+                source_end(other.source_end),
+                base_index(other.base_index + left_size) {
+                other.source_end= source_begin;
+            }
+
+            /// The number of elements to leave in the first part for an even
+            /// split
+            template <typename Split>
+            static size_t
+            split_point(size_t size, Split const &, std::false_type) noexcept {
+                return size / 2;
+            }
+
+            /// The number of elements to leave in the first part for a
+            /// proportional split. Both parts are non-empty if the range is
+            /// divisible
+            template <typename Split>
+            static size_t split_point(
+                size_t size, Split const &split_, std::true_type) noexcept {
+                double const left= static_cast<double>(split_.left());
+                double const total= left + static_cast<double>(split_.right());
+                if((size < 2) || !(total > 0))
+                    return size / 2;
+                size_t const left_size= static_cast<size_t>(
+                    static_cast<double>(size) * left / total + 0.5);
+                return left_size < 1 ?
+                           1 :
+                           (left_size > size - 1 ? size - 1 : left_size);
+            }
+
+            /// The start of the underlying range
+            UnderlyingIterator source_begin;
+            /// The end of the underlying range
+            UnderlyingIterator source_end;
+            /// The index of the first element
+            size_t base_index;
         };
 
-        /// A class derived from indexed_view_type that also holds a copy of the
-        /// range
+        /// An indexed view that holds a copy of the source range. Only the
+        /// range is stored: the underlying iterators are obtained from the
+        /// stored range whenever begin() or end() is called, so the view can
+        /// be moved or copied without leaving iterators that refer to the old
+        /// copy of the range
         template <
             typename Range, typename UnderlyingIterator,
             typename UnderlyingSentinel>
-        class extended_indexed_view_type
-            : range_holder<Range>,
-              public indexed_view_type<UnderlyingIterator, UnderlyingSentinel> {
+        class extended_indexed_view_type {
+        private:
+            /// The type of the view over the stored range
+            using view_type=
+                indexed_view_type<UnderlyingIterator, UnderlyingSentinel>;
+            /// Is constructing a view over the stored range nothrow?
+            static constexpr bool nothrow_get_view=
+                noexcept(view_type(
+                    std::begin(std::declval<Range &>()),
+                    std::end(std::declval<Range &>())));
+
         public:
-            /// Construct from a source range: move the range into storage and
-            /// then construct the indexed view over that storaged range
+            /// Construct from a source range: move the range into storage
             extended_indexed_view_type(Range &source) noexcept(
-                std::is_nothrow_move_constructible<Range>::value &&std::
-                    is_nothrow_move_constructible<UnderlyingIterator>::value
-                        &&std::is_nothrow_move_constructible<
-                            UnderlyingSentinel>::value
-                            &&noexcept(std::begin(std::declval<Range &>())) &&
-                noexcept(std::end(std::declval<Range &>()))) :
-                range_holder<Range>(source),
-                indexed_view_type<UnderlyingIterator, UnderlyingSentinel>(
-                    this->get_source_begin(), this->get_source_end()) {}
+                std::is_nothrow_move_constructible<Range>::value) :
+                source_range(std::move(source)) {}
+
+            /// The iterator for our range
+            using iterator= typename view_type::iterator;
+            /// The value_type of our range is an index/value pair
+            using value_type= typename view_type::value_type;
+
+            /// Get an iterator for the start of the stored range
+            iterator begin() noexcept(
+                nothrow_get_view &&noexcept(std::declval<view_type &>().begin())) {
+                return get_view().begin();
+            }
+            /// Get an iterator for the end of the stored range
+            iterator end() noexcept(
+                nothrow_get_view &&noexcept(std::declval<view_type &>().end())) {
+                return get_view().end();
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint. This takes constant time for random-access ranges
+            iterator resume(indexed_checkpoint const &checkpoint) {
+                return get_view().resume(checkpoint);
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, using the skip index for forward ranges
+            iterator resume(
+                indexed_checkpoint const &checkpoint,
+                indexed_skip_index<iterator> &skip_index) {
+                return get_view().resume(checkpoint, skip_index);
+            }
+
+            /// The number of elements in the range. Only available for
+            /// random-access ranges
+            size_t size() {
+                return get_view().size();
+            }
+
+            /// Is the range empty? Only available for random-access ranges
+            bool empty() {
+                return get_view().empty();
+            }
+
+        private:
+            /// Get a view over the stored range
+            view_type get_view() noexcept(nothrow_get_view) {
+                return view_type(std::begin(source_range), std::end(source_range));
+            }
+
+            /// The stored range
+            Range source_range;
+        };
+
+        /// An indexed view that shares ownership of the source range through
+        /// a reference-counted pointer, so copies are cheap. For
+        /// random-access ranges, the view can refer to a slice of the range,
+        /// where each element keeps its index in the whole range.
+        template <
+            typename Range, typename UnderlyingIterator,
+            typename UnderlyingSentinel>
+        class shared_indexed_view_type {
+        private:
+            /// The type of the view over the shared range
+            using view_type=
+                indexed_view_type<UnderlyingIterator, UnderlyingSentinel>;
+            /// Is the range random-access?
+            using random_access= is_random_access_range<
+                UnderlyingIterator, UnderlyingSentinel>;
+
+        public:
+            /// Construct a view over the whole of a shared range
+            explicit shared_indexed_view_type(
+                std::shared_ptr<Range> source_range_) noexcept :
+                source_range(std::move(source_range_)),
+                first(0), last(0), whole_range(true) {}
+
+            /// The iterator for our range
+            using iterator= typename view_type::iterator;
+            /// The value_type of our range is an index/value pair
+            using value_type= typename view_type::value_type;
+
+            /// Get an iterator for the start of the range
+            iterator begin() {
+                return get_view(random_access()).begin();
+            }
+            /// Get an iterator for the end of the range
+            iterator end() {
+                return get_view(random_access()).end();
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint. This takes constant time for random-access ranges
+            iterator resume(indexed_checkpoint const &checkpoint) {
+                return get_view(random_access()).resume(checkpoint);
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, using the skip index for forward ranges
+            iterator resume(
+                indexed_checkpoint const &checkpoint,
+                indexed_skip_index<iterator> &skip_index) {
+                return get_view(random_access()).resume(checkpoint, skip_index);
+            }
+
+            /// The number of elements in the range. Only available for
+            /// random-access ranges
+            size_t size() const {
+                return whole_range ? static_cast<size_t>(
+                                         std::end(*source_range) -
+                                         std::begin(*source_range)) :
+                                     last - first;
+            }
+
+            /// Is the range empty? Only available for random-access ranges
+            bool empty() const {
+                return !size();
+            }
+
+            /// Get a view of count elements of this view, starting at offset
+            /// within this view. The new view shares the same range, and
+            /// elements keep their indices. The slice is truncated at the end
+            /// of this view. Only available for random-access ranges
+            shared_indexed_view_type slice(size_t offset, size_t count) const {
+                size_t const current_size= size();
+                size_t const start=
+                    first + (offset < current_size ? offset : current_size);
+                size_t const available= first + current_size - start;
+                return shared_indexed_view_type(
+                    source_range, start,
+                    start + (count < available ? count : available));
+            }
+
+            /// Get the shared pointer to the range
+            std::shared_ptr<Range> const &get_range() const noexcept {
+                return source_range;
+            }
+
+        private:
+            /// Construct a view over a slice of a shared range
+            shared_indexed_view_type(
+                std::shared_ptr<Range> source_range_, size_t first_,
+                size_t last_) noexcept :
+                source_range(std::move(source_range_)),
+                first(first_), last(last_), whole_range(false) {}
+
+            /// Get a view over the slice of a random-access range
+            view_type get_view(std::true_type) {
+                if(whole_range)
+                    return view_type(
+                        std::begin(*source_range), std::end(*source_range));
+                auto const source_begin= std::begin(*source_range);
+                return view_type(
+                    source_begin + static_cast<ptrdiff_t>(first),
+                    source_begin + static_cast<ptrdiff_t>(last), first);
+            }
+
+            /// Get a view over the whole of another range
+            view_type get_view(std::false_type) {
+                return view_type(
+                    std::begin(*source_range), std::end(*source_range));
+            }
+
+            /// The shared range
+            std::shared_ptr<Range> source_range;
+            /// The offset of the start of the slice
+            size_t first;
+            /// The offset of the end of the slice
+            size_t last;
+            /// Does the view cover the whole range?
+            bool whole_range;
+        };
+
+        /// A type that encapsulates an indexed view over a counted range
+        /// starting at an underlying iterator. Iteration terminates when the
+        /// index reaches the count, so the underlying iterator is never
+        /// compared with anything
+        template <typename UnderlyingIterator> class counted_indexed_view_type {
+        private:
+            /// Is the underlying iterator nothrow move constructible?
+            static constexpr bool nothrow_move_iterators=
+                std::is_nothrow_move_constructible<UnderlyingIterator>::value;
+            /// Is the iterator nothrow copy constructible?
+            static constexpr bool nothrow_copy_iterators=
+                std::is_nothrow_copy_constructible<UnderlyingIterator>::value;
+
+        public:
+            /// Construct a range from an iterator and a count
+            counted_indexed_view_type(
+                UnderlyingIterator &&begin_,
+                size_t count_) noexcept(nothrow_move_iterators) :
+                source_begin(std::move(begin_)),
+                count(count_) {}
+
+            /// The iterator for our range
+            using iterator= counted_indexed_iterator<UnderlyingIterator>;
+            /// The value_type of our range is an index/value pair
+            using value_type= typename iterator::value_type;
+
+            /// Get an iterator for the start of the range
+            iterator begin() noexcept(nothrow_copy_iterators) {
+                return iterator(0, source_begin);
+            }
+            /// Get an iterator for the end of the range. This holds a copy of
+            /// the start iterator, but only the index is ever used
+            iterator end() noexcept(nothrow_copy_iterators) {
+                return iterator(count, source_begin);
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, or end() if the index is past the end. This takes
+            /// constant time for random-access iterators
+            iterator resume(indexed_checkpoint const &checkpoint) {
+                if(checkpoint.index >= count)
+                    return end();
+                UnderlyingIterator source= source_begin;
+                std::advance(
+                    source,
+                    static_cast<
+                        typename std::iterator_traits<UnderlyingIterator>::
+                            difference_type>(checkpoint.index));
+                return iterator(checkpoint.index, source);
+            }
+
+            /// Get an iterator for the element with the index stored in the
+            /// checkpoint, or end() if the index is past the end. For
+            /// iterators that are not random-access, this advances from the
+            /// nearest position recorded in skip_index, recording positions
+            /// passed on the way
+            iterator resume(
+                indexed_checkpoint const &checkpoint,
+                indexed_skip_index<iterator> &skip_index) {
+                if constexpr(is_random_access_iterator<
+                                 UnderlyingIterator>::value) {
+                    return resume(checkpoint);
+                } else {
+                    static_assert(
+                        is_forward_iterator<UnderlyingIterator>::value,
+                        "Skip indexes require forward iterators");
+                    if(checkpoint.index >= count)
+                        return end();
+                    return resume_from_skip_index(
+                        begin(), end(), checkpoint.index, skip_index);
+                }
+            }
+
+        private:
+            /// The start of the underlying range
+            UnderlyingIterator source_begin;
+            /// The number of elements in the range
+            size_t count;
         };
 
     }
@@ -410,6 +1460,46 @@ namespace jss {
             std::move(source_begin), std::move(source_end));
     }
 
+    /// Construct an indexed view that shares ownership of the supplied
+    /// range. Copies of the view share the same range
+    template <typename Range>
+    auto shared_indexed_view(std::shared_ptr<Range> source)
+        -> detail::shared_indexed_view_type<
+            Range, decltype(std::begin(*source)), decltype(std::end(*source))> {
+        return detail::shared_indexed_view_type<
+            Range, decltype(std::begin(*source)), decltype(std::end(*source))>(
+            std::move(source));
+    }
+
+    /// Construct an indexed view that shares ownership of a copy of the
+    /// supplied range, moving from rvalues. Copies of the view share the same
+    /// copy of the range
+    template <typename Range>
+    auto shared_indexed_view(Range &&source) -> decltype(shared_indexed_view(
+        std::make_shared<typename std::decay<Range>::type>(
+            std::forward<Range>(source)))) {
+        return shared_indexed_view(
+            std::make_shared<typename std::decay<Range>::type>(
+                std::forward<Range>(source)));
+    }
+
+    /// Construct an indexed view over the count elements starting at
+    /// source_begin. Termination is determined by the index alone, so the
+    /// underlying iterator is never compared. The source range must be valid
+    /// until the view is no longer used, and must have at least count elements
+    template <typename UnderlyingIterator>
+    auto indexed_view_n(
+        UnderlyingIterator source_begin,
+        size_t count) noexcept(noexcept(detail::
+                                            counted_indexed_view_type<
+                                                UnderlyingIterator>(
+                                                std::move(source_begin),
+                                                count)))
+        -> detail::counted_indexed_view_type<UnderlyingIterator> {
+        return detail::counted_indexed_view_type<UnderlyingIterator>(
+            std::move(source_begin), count);
+    }
+
 }
 
 #endif
@@ -0,0 +1,372 @@
+#ifndef JSS_INDEXED_VIEW_BITS_HPP
+#define JSS_INDEXED_VIEW_BITS_HPP
+#include "indexed_view.hpp"
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace jss {
+    namespace detail {
+        /// The number of trailing zero bits in a non-zero word
+        inline unsigned count_trailing_zeros(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long result;
+            _BitScanForward64(&result, word);
+            return static_cast<unsigned>(result);
+#else
+            unsigned result= 0;
+            while(!(word & 1)) {
+                word>>= 1;
+                ++result;
+            }
+            return result;
+#endif
+        }
+
+        /// The number of set bits in a word
+        inline unsigned population_count(uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+            word= word - ((word >> 1) & 0x5555555555555555ull);
+            word= (word & 0x3333333333333333ull) +
+                  ((word >> 2) & 0x3333333333333333ull);
+            word= (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        /// The word type used to hold the bits of a std::vector<bool>. Define
+        /// JSS_INDEXED_VIEW_PORTABLE_BIT_VECTOR to pack the bits instead of
+        /// using the words of libstdc++'s std::vector<bool>
+#if defined(__GLIBCXX__) && !defined(_GLIBCXX_DEBUG) &&                        \
+    !defined(JSS_INDEXED_VIEW_PORTABLE_BIT_VECTOR)
+#define JSS_INDEXED_VIEW_HAS_BIT_VECTOR_WORDS
+        using bit_vector_word= std::_Bit_type;
+#else
+        using bit_vector_word= uint64_t;
+#endif
+    }
+
+    /// A view that yields the positions of the set bits in a sequence of
+    /// unsigned words, where bit i of the sequence is bit i%N of word i/N for
+    /// N-bit words. Each element has an index, which is the number of set
+    /// bits before it, and a value, which is the position of the bit. Whole
+    /// words are scanned at a time, so iterating over the view takes
+    /// O(popcount + n/N) operations rather than O(n). The view refers to the
+    /// words, which must remain valid while the view is used, unless it was
+    /// constructed by packing the bits of a std::vector<bool>.
+    template <typename Word> class set_bit_indices_view {
+        static_assert(
+            std::is_unsigned<Word>::value &&
+                (std::numeric_limits<Word>::digits <= 64),
+            "Words must be unsigned integers of at most 64 bits");
+
+    public:
+        /// The number of bits in a word
+        static constexpr size_t word_bits= std::numeric_limits<Word>::digits;
+
+        /// The value_type of our range is the index of the set bit among all
+        /// the set bits, and its position
+        struct value_type {
+            size_t index;
+            size_t value;
+        };
+
+        /// Construct a view over the first bit_count_ bits of the words
+        set_bit_indices_view(Word const *words_, size_t bit_count_) noexcept :
+            external_words(words_), bit_count(bit_count_) {}
+
+        /// Construct a view that holds its own copy of the words
+        set_bit_indices_view(std::vector<Word> &&words_, size_t bit_count_) :
+            external_words(nullptr), packed_words(std::move(words_)),
+            bit_count(bit_count_) {}
+
+        /// The iterator for our range
+        class iterator {
+            /// Proxy for ->
+            using arrow_proxy=
+                detail::arrow_proxy<typename set_bit_indices_view::value_type>;
+            /// Proxy for handling *x++
+            using postinc_return= detail::postinc_return<
+                typename set_bit_indices_view::value_type>;
+
+        public:
+            /// Required iterator typedefs
+            using value_type= typename set_bit_indices_view::value_type;
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs
+            using iterator_category= std::input_iterator_tag;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= void;
+
+            /// Compare iterators. Iterators are equal if they refer to the
+            /// same bit
+            friend bool
+            operator==(iterator const &lhs, iterator const &rhs) noexcept {
+                return (lhs.word_index == rhs.word_index) &&
+                       (lhs.current == rhs.current);
+            }
+            /// Compare iterators
+            friend bool
+            operator!=(iterator const &lhs, iterator const &rhs) noexcept {
+                return !(lhs == rhs);
+            }
+
+            /// Dereference the iterator
+            value_type operator*() const noexcept {
+                return value_type{
+                    index,
+                    word_index * word_bits +
+                        detail::count_trailing_zeros(current)};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const noexcept {
+                return arrow_proxy{**this};
+            }
+
+            /// Pre-increment: clear the lowest set bit, and move to the next
+            /// non-zero word if there are no more set bits in this one
+            iterator &operator++() noexcept {
+                ++index;
+                current&= current - 1;
+                if(!current) {
+                    ++word_index;
+                    find_next_set_bit();
+                }
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) noexcept {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+        private:
+            friend class set_bit_indices_view;
+
+            /// Construct an iterator for the first set bit at or after the
+            /// start of the specified word
+            iterator(
+                Word const *words_, size_t word_count_, size_t bit_count_,
+                size_t word_index_) noexcept :
+                words(words_),
+                word_count(word_count_), bit_count(bit_count_), index(0),
+                word_index(word_index_), current(0) {
+                find_next_set_bit();
+            }
+
+            /// Load the word at word_index, masking off the bits past the
+            /// end of the sequence
+            uint64_t load_word() const noexcept {
+                uint64_t word= static_cast<uint64_t>(words[word_index]);
+                size_t const end_bit= (word_index + 1) * word_bits;
+                if(end_bit > bit_count) {
+                    size_t const valid_bits= word_bits - (end_bit - bit_count);
+                    word&= (uint64_t(1) << valid_bits) - 1;
+                }
+                return word;
+            }
+
+            /// Move to the first non-zero word at or after word_index, or to
+            /// the end
+            void find_next_set_bit() noexcept {
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+                skip_zero_blocks();
+#endif
+                for(; word_index < word_count; ++word_index) {
+                    current= load_word();
+                    if(current)
+                        return;
+                }
+                word_index= word_count;
+                current= 0;
+            }
+
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            /// Skip 16-byte blocks of zero words, so sparse sequences are
+            /// scanned 128 bits at a time. The last word is never skipped
+            /// here, as it may need masking
+            void skip_zero_blocks() noexcept {
+                constexpr size_t block_words= 16 / sizeof(Word);
+                __m128i const zero= _mm_setzero_si128();
+                while(word_index + block_words < word_count) {
+                    __m128i const block= _mm_loadu_si128(
+                        reinterpret_cast<__m128i const *>(words + word_index));
+                    if(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)) !=
+                       0xffff)
+                        return;
+                    word_index+= block_words;
+                }
+            }
+#endif
+
+            /// The words
+            Word const *words;
+            /// The number of words
+            size_t word_count;
+            /// The number of bits in the sequence
+            size_t bit_count;
+            /// The number of set bits before this one
+            size_t index;
+            /// The index of the current word
+            size_t word_index;
+            /// The unvisited set bits of the current word
+            uint64_t current;
+        };
+
+        /// Get an iterator for the first set bit
+        iterator begin() const noexcept {
+            return iterator(get_words(), word_count(), bit_count, 0);
+        }
+
+        /// Get an iterator for the end of the range
+        iterator end() const noexcept {
+            return iterator(get_words(), word_count(), bit_count, word_count());
+        }
+
+        /// The number of set bits. This counts the bits a word at a time
+        size_t size() const noexcept {
+            Word const *const words= get_words();
+            size_t const full_words= bit_count / word_bits;
+            size_t count= 0;
+            for(size_t i= 0; i < full_words; ++i) {
+                count+= detail::population_count(static_cast<uint64_t>(words[i]));
+            }
+            if(size_t const extra_bits= bit_count % word_bits) {
+                count+= detail::population_count(
+                    static_cast<uint64_t>(words[full_words]) &
+                    ((uint64_t(1) << extra_bits) - 1));
+            }
+            return count;
+        }
+
+        /// Are there no set bits?
+        bool empty() const noexcept {
+            return begin() == end();
+        }
+
+    private:
+        /// The words to scan
+        Word const *get_words() const noexcept {
+            return external_words ? external_words : packed_words.data();
+        }
+
+        /// The number of words holding the bits
+        size_t word_count() const noexcept {
+            return (bit_count + word_bits - 1) / word_bits;
+        }
+
+        /// The words, if the view refers to external words
+        Word const *external_words;
+        /// The words, if the view holds its own copy
+        std::vector<Word> packed_words;
+        /// The number of bits in the sequence
+        size_t bit_count;
+    };
+
+    /// Create a view over the positions of the set bits in the first
+    /// bit_count bits of the sequence of words starting at words
+    template <typename Word>
+    set_bit_indices_view<Word>
+    set_bit_indices(Word const *words, size_t bit_count) noexcept {
+        return set_bit_indices_view<Word>(words, bit_count);
+    }
+
+    namespace detail {
+        /// The word type of a contiguous range of words
+        template <typename Words>
+        using word_type_of= typename std::remove_const<
+            typename std::remove_pointer<decltype(std::data(
+                std::declval<Words const &>()))>::type>::type;
+
+        /// Pack the bits of a std::vector<bool> into words held by a view
+        template <typename Allocator>
+        set_bit_indices_view<bit_vector_word>
+        pack_bit_vector(std::vector<bool, Allocator> const &bits) {
+            using view_type= set_bit_indices_view<bit_vector_word>;
+            std::vector<bit_vector_word> words(
+                (bits.size() + view_type::word_bits - 1) /
+                view_type::word_bits);
+            for(size_t i= 0; i < bits.size(); ++i) {
+                if(bits[i])
+                    words[i / view_type::word_bits]|=
+                        bit_vector_word(1) << (i % view_type::word_bits);
+            }
+            return view_type(std::move(words), bits.size());
+        }
+    }
+
+    /// Create a view over the positions of the set bits in a contiguous
+    /// range of unsigned words, such as a std::vector<uint64_t>. The view
+    /// refers to the words, which must outlive it
+    template <typename Words, typename Word= detail::word_type_of<Words>>
+    set_bit_indices_view<Word> set_bit_indices(Words const &words) noexcept {
+        return set_bit_indices_view<Word>(
+            std::data(words),
+            std::size(words) * set_bit_indices_view<Word>::word_bits);
+    }
+
+    /// Create a view over the positions of the set bits in a temporary
+    /// contiguous range of unsigned words. The view holds its own copy of
+    /// the words, moved from the range if it is a std::vector of words, so
+    /// it can be used after the range is destroyed, as for indexed_view
+    template <
+        typename Words, typename Word= detail::word_type_of<Words>,
+        typename= typename std::enable_if<
+            !std::is_lvalue_reference<Words>::value>::type>
+    set_bit_indices_view<Word> set_bit_indices(Words &&words) {
+        size_t const bit_count=
+            std::size(words) * set_bit_indices_view<Word>::word_bits;
+        if constexpr(std::is_same<Words, std::vector<Word>>::value) {
+            return set_bit_indices_view<Word>(std::move(words), bit_count);
+        } else {
+            return set_bit_indices_view<Word>(
+                std::vector<Word>(std::begin(words), std::end(words)),
+                bit_count);
+        }
+    }
+
+    /// Create a view over the positions of the set bits in a
+    /// std::vector<bool>. With libstdc++ (outside debug mode) the view refers
+    /// to the words of the vector directly, so the vector must outlive the
+    /// view. Otherwise the bits are packed into words held by the view, as
+    /// the layout of std::vector<bool> is not accessible.
+    template <typename Allocator>
+    set_bit_indices_view<detail::bit_vector_word>
+    set_bit_indices(std::vector<bool, Allocator> const &bits) {
+#ifdef JSS_INDEXED_VIEW_HAS_BIT_VECTOR_WORDS
+        return set_bit_indices_view<detail::bit_vector_word>(
+            bits.begin()._M_p, bits.size());
+#else
+        return detail::pack_bit_vector(bits);
+#endif
+    }
+
+    /// Create a view over the positions of the set bits in a temporary
+    /// std::vector<bool>. The bits are packed into words held by the view,
+    /// so it can be used after the vector is destroyed
+    template <typename Allocator>
+    set_bit_indices_view<detail::bit_vector_word>
+    set_bit_indices(std::vector<bool, Allocator> &&bits) {
+        return detail::pack_bit_vector(bits);
+    }
+}
+
+#endif
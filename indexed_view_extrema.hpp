@@ -0,0 +1,445 @@
+#ifndef JSS_INDEXED_VIEW_EXTREMA_HPP
+#define JSS_INDEXED_VIEW_EXTREMA_HPP
+#include "indexed_view.hpp"
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace jss {
+    namespace detail {
+        /// Tag for finding the smallest value
+        struct min_tag {
+            /// Is lhs better than rhs?
+            template <typename T>
+            static bool better(T const &lhs, T const &rhs) {
+                return lhs < rhs;
+            }
+        };
+
+        /// Tag for finding the largest value
+        struct max_tag {
+            /// Is lhs better than rhs?
+            template <typename T>
+            static bool better(T const &lhs, T const &rhs) {
+                return rhs < lhs;
+            }
+        };
+
+        /// Find the offset of the first best value in a non-empty array
+        template <typename T, typename Tag>
+        size_t scalar_extreme_offset(T const *values, size_t size, Tag) {
+            size_t best= 0;
+            for(size_t i= 1; i < size; ++i) {
+                if(Tag::better(values[i], values[best]))
+                    best= i;
+            }
+            return best;
+        }
+
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+        /// The maximum number of values searched at once with SIMD, so the
+        /// offsets fit in 32-bit lanes
+        constexpr size_t simd_extreme_segment_size= size_t(1) << 30;
+
+        /// Load four values
+        inline __m128i simd_load(int32_t const *values) noexcept {
+            return _mm_loadu_si128(reinterpret_cast<__m128i const *>(values));
+        }
+        /// Load four values
+        inline __m128 simd_load(float const *values) noexcept {
+            return _mm_loadu_ps(values);
+        }
+
+        /// Store four values
+        inline void simd_store(int32_t *values, __m128i v) noexcept {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(values), v);
+        }
+        /// Store four values
+        inline void simd_store(float *values, __m128 v) noexcept {
+            _mm_storeu_ps(values, v);
+        }
+
+        /// Set all four lanes to the same value
+        inline __m128i simd_broadcast(int32_t value) noexcept {
+            return _mm_set1_epi32(value);
+        }
+        /// Set all four lanes to the same value
+        inline __m128 simd_broadcast(float value) noexcept {
+            return _mm_set1_ps(value);
+        }
+
+        /// A mask of the lanes where lhs is better than rhs
+        inline __m128i simd_better(__m128i lhs, __m128i rhs, min_tag) noexcept {
+            return _mm_cmplt_epi32(lhs, rhs);
+        }
+        /// A mask of the lanes where lhs is better than rhs
+        inline __m128i simd_better(__m128i lhs, __m128i rhs, max_tag) noexcept {
+            return _mm_cmpgt_epi32(lhs, rhs);
+        }
+        /// A mask of the lanes where lhs is better than rhs
+        inline __m128 simd_better(__m128 lhs, __m128 rhs, min_tag) noexcept {
+            return _mm_cmplt_ps(lhs, rhs);
+        }
+        /// A mask of the lanes where lhs is better than rhs
+        inline __m128 simd_better(__m128 lhs, __m128 rhs, max_tag) noexcept {
+            return _mm_cmpgt_ps(lhs, rhs);
+        }
+
+        /// The mask as integer lanes
+        inline __m128i simd_integer_mask(__m128i mask) noexcept {
+            return mask;
+        }
+        /// The mask as integer lanes
+        inline __m128i simd_integer_mask(__m128 mask) noexcept {
+            return _mm_castps_si128(mask);
+        }
+
+        /// Select the lanes of lhs where mask is set, and of rhs otherwise
+        inline __m128i
+        simd_select(__m128i mask, __m128i lhs, __m128i rhs) noexcept {
+            return _mm_or_si128(
+                _mm_and_si128(mask, lhs), _mm_andnot_si128(mask, rhs));
+        }
+        /// Select the lanes of lhs where mask is set, and of rhs otherwise
+        inline __m128
+        simd_select(__m128 mask, __m128 lhs, __m128 rhs) noexcept {
+            return _mm_or_ps(_mm_and_ps(mask, lhs), _mm_andnot_ps(mask, rhs));
+        }
+
+        /// Find the offset of the first best value in a non-empty array of
+        /// at most simd_extreme_segment_size values. Each lane of two
+        /// independent accumulators tracks the best value and its offset
+        /// for every eighth value, using compare-and-blend, and then the
+        /// lanes are combined
+        template <typename T, typename Tag>
+        size_t simd_extreme_offset(T const *values, size_t size, Tag tag) {
+            if(size < 16)
+                return scalar_extreme_offset(values, size, tag);
+            auto best_low= simd_load(values);
+            auto best_high= simd_load(values + 4);
+            __m128i best_low_offsets= _mm_setr_epi32(0, 1, 2, 3);
+            __m128i best_high_offsets= _mm_setr_epi32(4, 5, 6, 7);
+            __m128i low_offsets= best_low_offsets;
+            __m128i high_offsets= best_high_offsets;
+            __m128i const step= _mm_set1_epi32(8);
+            size_t i= 8;
+            for(; i + 8 <= size; i+= 8) {
+                low_offsets= _mm_add_epi32(low_offsets, step);
+                high_offsets= _mm_add_epi32(high_offsets, step);
+                auto const low= simd_load(values + i);
+                auto const high= simd_load(values + i + 4);
+                auto const low_mask= simd_better(low, best_low, tag);
+                auto const high_mask= simd_better(high, best_high, tag);
+                best_low= simd_select(low_mask, low, best_low);
+                best_high= simd_select(high_mask, high, best_high);
+                best_low_offsets= simd_select(
+                    simd_integer_mask(low_mask), low_offsets,
+                    best_low_offsets);
+                best_high_offsets= simd_select(
+                    simd_integer_mask(high_mask), high_offsets,
+                    best_high_offsets);
+            }
+            T lane_values[8];
+            int32_t lane_offsets[8];
+            simd_store(lane_values, best_low);
+            simd_store(lane_values + 4, best_high);
+            simd_store(lane_offsets, best_low_offsets);
+            simd_store(lane_offsets + 4, best_high_offsets);
+            size_t best= static_cast<size_t>(lane_offsets[0]);
+            for(unsigned lane= 1; lane < 8; ++lane) {
+                size_t const offset= static_cast<size_t>(lane_offsets[lane]);
+                if(Tag::better(lane_values[lane], values[best]) ||
+                   (!Tag::better(values[best], lane_values[lane]) &&
+                    (offset < best)))
+                    best= offset;
+            }
+            for(; i < size; ++i) {
+                if(Tag::better(values[i], values[best]))
+                    best= i;
+            }
+            return best;
+        }
+#endif
+
+        /// Can values of type T be searched with SIMD instructions?
+        template <typename T>
+        struct is_simd_extreme_type
+            : std::integral_constant<
+                  bool,
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+                  std::is_same<T, int32_t>::value ||
+                      std::is_same<T, float>::value
+#else
+                  false
+#endif
+                  > {
+        };
+
+        /// Find the offset of the first best value in a non-empty array
+        template <typename T, typename Tag>
+        size_t
+        contiguous_extreme_offset(T const *values, size_t size, Tag tag) {
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            if constexpr(is_simd_extreme_type<T>::value) {
+                size_t best= 0;
+                for(size_t offset= 0; offset < size;
+                    offset+= simd_extreme_segment_size) {
+                    size_t const count=
+                        size - offset < simd_extreme_segment_size ?
+                            size - offset :
+                            simd_extreme_segment_size;
+                    size_t const candidate=
+                        offset +
+                        simd_extreme_offset(values + offset, count, tag);
+                    if(Tag::better(values[candidate], values[best]))
+                        best= candidate;
+                }
+                return best;
+            }
+#endif
+            return scalar_extreme_offset(values, size, tag);
+        }
+
+        /// Find the index of the first best element of a contiguous range of
+        /// arithmetic values. Comparing arithmetic values cannot throw, so
+        /// the elements are not tracked
+        template <typename Iterator, typename Tag, typename Tracker>
+        std::optional<size_t> arg_extreme(
+            Iterator const &first, Iterator const &last, Tag tag,
+            std::true_type, Tracker) {
+            auto const values= get_contiguous_values(first, last);
+            if(!values.size)
+                return std::nullopt;
+            using value_type=
+                typename std::remove_cv<typename std::remove_pointer<
+                    decltype(values.data)>::type>::type;
+            return values.base_index +
+                   contiguous_extreme_offset(
+                       static_cast<value_type const *>(values.data),
+                       values.size, tag);
+        }
+
+        /// Find the index of the first best element of any other range,
+        /// passing the index of each element to tracker before it is
+        /// compared
+        template <typename Iterator, typename Tag, typename Tracker>
+        std::optional<size_t> arg_extreme(
+            Iterator first, Iterator const &last, Tag, std::false_type,
+            Tracker tracker) {
+            if(first == last)
+                return std::nullopt;
+            auto &&initial= *first;
+            size_t best_index= initial.index;
+            tracker.reached(best_index);
+            typename std::decay<decltype(initial.value)>::type best_value=
+                initial.value;
+            for(++first; first != last; ++first) {
+                auto &&entry= *first;
+                tracker.reached(entry.index);
+                if(Tag::better(entry.value, best_value)) {
+                    best_value= entry.value;
+                    best_index= entry.index;
+                }
+            }
+            return best_index;
+        }
+
+        /// A value and its index, for selecting the top values
+        template <typename T> struct ranked_value {
+            T value;
+            size_t index;
+        };
+
+        /// Does lhs rank before rhs? Larger values rank first, and equal
+        /// values are ranked by index
+        template <typename T>
+        bool ranks_before(
+            ranked_value<T> const &lhs, ranked_value<T> const &rhs) {
+            return (rhs.value < lhs.value) ||
+                   (!(lhs.value < rhs.value) && (lhs.index < rhs.index));
+        }
+
+        /// The top k values seen so far, held in a heap with the lowest
+        /// ranked value at the front
+        template <typename T> class top_k_selection {
+        public:
+            /// Construct an empty selection that holds up to k values
+            explicit top_k_selection(size_t k_) : k(k_) {
+                heap.reserve(k);
+            }
+
+            /// Is the selection full?
+            bool full() const noexcept {
+                return heap.size() == k;
+            }
+
+            /// The lowest ranked value in a full selection
+            T const &threshold() const noexcept {
+                return heap.front().value;
+            }
+
+            /// Add a value, if it ranks before the lowest ranked value in a
+            /// full selection
+            void add(T const &value, size_t index) {
+                ranked_value<T> candidate{value, index};
+                if(heap.size() < k) {
+                    heap.push_back(std::move(candidate));
+                    std::push_heap(heap.begin(), heap.end(), ranks_before<T>);
+                } else if(k && ranks_before(candidate, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), ranks_before<T>);
+                    heap.back()= std::move(candidate);
+                    std::push_heap(heap.begin(), heap.end(), ranks_before<T>);
+                }
+            }
+
+            /// Extract the values, highest ranked first
+            std::vector<ranked_value<T>> take() {
+                std::sort_heap(heap.begin(), heap.end(), ranks_before<T>);
+                return std::move(heap);
+            }
+
+        private:
+            /// The maximum number of values
+            size_t k;
+            /// The heap of values
+            std::vector<ranked_value<T>> heap;
+        };
+
+        /// Select the top k values in a contiguous array. Once k values have
+        /// been selected, values are compared against the threshold four at
+        /// a time with SIMD where possible, and only values that beat the
+        /// threshold are added
+        template <typename T>
+        void select_top_k(
+            top_k_selection<T> &selection, T const *values, size_t size,
+            size_t base_index) {
+            size_t i= 0;
+            for(; (i < size) && !selection.full(); ++i) {
+                selection.add(values[i], base_index + i);
+            }
+            if(!selection.full())
+                return;
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            if constexpr(is_simd_extreme_type<T>::value) {
+                auto threshold= simd_broadcast(selection.threshold());
+                for(; i + 4 <= size; i+= 4) {
+                    int const mask=
+                        _mm_movemask_epi8(simd_integer_mask(simd_better(
+                            simd_load(values + i), threshold, max_tag())));
+                    if(!mask)
+                        continue;
+                    for(unsigned lane= 0; lane < 4; ++lane) {
+                        if(mask & (1 << (lane * 4)))
+                            selection.add(
+                                values[i + lane], base_index + i + lane);
+                    }
+                    threshold= simd_broadcast(selection.threshold());
+                }
+            }
+#endif
+            for(; i < size; ++i) {
+                if(selection.threshold() < values[i])
+                    selection.add(values[i], base_index + i);
+            }
+        }
+
+        /// Select the top k values of a contiguous range of arithmetic values.
+        /// Room for the selection is reserved up front, and arithmetic values
+        /// cannot throw when copied or compared, so the elements are not
+        /// tracked
+        template <typename Iterator, typename Tracker>
+        auto select_top_k(
+            Iterator const &first, Iterator const &last, size_t k,
+            std::true_type, Tracker) {
+            auto const values= get_contiguous_values(first, last);
+            using value_type=
+                typename std::remove_cv<typename std::remove_pointer<
+                    decltype(values.data)>::type>::type;
+            top_k_selection<value_type> selection(k);
+            if(k)
+                select_top_k(
+                    selection, static_cast<value_type const *>(values.data),
+                    values.size, values.base_index);
+            return selection.take();
+        }
+
+        /// Select the top k values of any other range, passing the index of
+        /// each element to tracker before it is added
+        template <typename Iterator, typename Tracker>
+        auto select_top_k(
+            Iterator first, Iterator const &last, size_t k, std::false_type,
+            Tracker tracker) {
+            using value_type=
+                typename std::decay<decltype((*first).value)>::type;
+            top_k_selection<value_type> selection(k);
+            if(k) {
+                for(; first != last; ++first) {
+                    auto &&entry= *first;
+                    tracker.reached(entry.index);
+                    selection.add(entry.value, entry.index);
+                }
+            }
+            return selection.take();
+        }
+
+        /// The indices of the ranked values
+        template <typename T>
+        std::vector<size_t>
+        ranked_indices(std::vector<ranked_value<T>> const &ranked) {
+            std::vector<size_t> result;
+            result.reserve(ranked.size());
+            for(auto const &entry : ranked) {
+                result.push_back(entry.index);
+            }
+            return result;
+        }
+    }
+
+    /// Find the index of the first smallest value in the view, or
+    /// std::nullopt if the view is empty. Values are compared with <. For
+    /// views over contiguous ranges of int32_t or float, the values are
+    /// compared four at a time with SIMD instructions where available;
+    /// other views are searched one element at a time. Floating-point
+    /// values must not be NaN.
+    template <typename View> std::optional<size_t> argmin(View &&view) {
+        auto first= view.begin();
+        auto last= view.end();
+        return detail::arg_extreme(
+            first, last, detail::min_tag(),
+            detail::is_contiguous_arithmetic_iterator<decltype(first)>(),
+            detail::no_element_tracker());
+    }
+
+    /// Find the index of the first largest value in the view, or
+    /// std::nullopt if the view is empty, as for argmin
+    template <typename View> std::optional<size_t> argmax(View &&view) {
+        auto first= view.begin();
+        auto last= view.end();
+        return detail::arg_extreme(
+            first, last, detail::max_tag(),
+            detail::is_contiguous_arithmetic_iterator<decltype(first)>(),
+            detail::no_element_tracker());
+    }
+
+    /// Find the indices of the k largest values in the view, largest first.
+    /// Equal values are ordered by index. If the view has fewer than k
+    /// elements, the indices of all the elements are returned. Values are
+    /// compared with <, and copied. For views over contiguous ranges of
+    /// int32_t or float, values that cannot be in the top k are rejected
+    /// four at a time with SIMD instructions where available.
+    template <typename View>
+    std::vector<size_t> top_k_indices(View &&view, size_t k) {
+        auto first= view.begin();
+        auto last= view.end();
+        return detail::ranked_indices(detail::select_top_k(
+            first, last, k,
+            detail::is_contiguous_arithmetic_iterator<decltype(first)>(),
+            detail::no_element_tracker()));
+    }
+}
+
+#endif
@@ -0,0 +1,850 @@
+#ifndef JSS_INDEXED_VIEW_IO_HPP
+#define JSS_INDEXED_VIEW_IO_HPP
+#include "indexed_view.hpp"
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#define JSS_INDEXED_VIEW_HAS_IO_URING
+#endif
+#endif
+#endif
+
+namespace jss {
+    /// The format of the records in a record source: either separated by a
+    /// delimiter character, or a fixed number of bytes each
+    class record_format {
+    public:
+        /// Records separated by the specified delimiter. The delimiter is not
+        /// included in the records
+        static record_format delimited(char delimiter_= '\n') noexcept {
+            return record_format(delimiter_, 0);
+        }
+
+        /// Records of a fixed number of bytes
+        static record_format fixed_size(size_t record_size_) noexcept {
+            return record_format(0, record_size_ ? record_size_ : 1);
+        }
+
+        /// Are the records delimited?
+        bool is_delimited() const noexcept {
+            return !record_size;
+        }
+        /// The delimiter for delimited records
+        char get_delimiter() const noexcept {
+            return delimiter;
+        }
+        /// The size of fixed-size records
+        size_t get_record_size() const noexcept {
+            return record_size;
+        }
+
+    private:
+        record_format(char delimiter_, size_t record_size_) noexcept :
+            delimiter(delimiter_), record_size(record_size_) {}
+
+        /// The delimiter for delimited records
+        char delimiter;
+        /// The size of fixed-size records, or 0 for delimited records
+        size_t record_size;
+    };
+
+    namespace detail {
+        /// A buffer aligned to a page boundary, suitable for large reads
+        class aligned_buffer {
+        public:
+            /// The alignment of the buffer
+            static constexpr size_t alignment= 4096;
+
+            /// Allocate a buffer of the specified size
+            explicit aligned_buffer(size_t size_) :
+                buffer(static_cast<char *>(
+                    ::operator new(size_, std::align_val_t(alignment)))),
+                buffer_size(size_) {}
+
+            /// The start of the buffer
+            char *data() const noexcept {
+                return buffer.get();
+            }
+            /// The size of the buffer
+            size_t size() const noexcept {
+                return buffer_size;
+            }
+
+        private:
+            /// Deleter for the aligned memory
+            struct deleter {
+                void operator()(char *p) const noexcept {
+                    ::operator delete(p, std::align_val_t(alignment));
+                }
+            };
+
+            /// The memory
+            std::unique_ptr<char, deleter> buffer;
+            /// The size of the buffer
+            size_t buffer_size;
+        };
+
+        /// Read from fd into buffer with read() if offset is -1, or pread()
+        /// otherwise, retrying if interrupted. Returns the number of bytes
+        /// read, which is 0 at end of file
+        inline size_t
+        read_some(int fd, char *buffer, size_t size, off_t offset) {
+            for(;;) {
+                ssize_t const result= (offset == -1) ?
+                                          ::read(fd, buffer, size) :
+                                          ::pread(fd, buffer, size, offset);
+                if(result >= 0)
+                    return static_cast<size_t>(result);
+                if(errno != EINTR)
+                    throw std::system_error(errno, std::generic_category());
+            }
+        }
+
+        /// Fill the buffer with pread() from offset, stopping early only at
+        /// end of file. Returns the number of bytes read
+        inline size_t read_fully(int fd, char *buffer, size_t size, off_t offset) {
+            size_t total= 0;
+            while(total < size) {
+                size_t const result= read_some(
+                    fd, buffer + total, size - total,
+                    offset + static_cast<off_t>(total));
+                if(!result)
+                    break;
+                total+= result;
+            }
+            return total;
+        }
+
+        /// Reads blocks synchronously with read() or pread() into a single
+        /// buffer
+        class sync_block_reader {
+        public:
+            /// Read blocks of block_size bytes from fd, starting at offset,
+            /// or the current file position if offset is -1
+            sync_block_reader(int fd_, size_t block_size, off_t offset_) :
+                fd(fd_), offset(offset_), buffer(block_size) {}
+
+            /// Read the next block. The previous block is no longer valid. An
+            /// empty block indicates the end of the file
+            std::string_view next_block() {
+                size_t const size=
+                    read_some(fd, buffer.data(), buffer.size(), offset);
+                if(offset != -1)
+                    offset+= static_cast<off_t>(size);
+                return std::string_view(buffer.data(), size);
+            }
+
+        private:
+            /// The file descriptor
+            int fd;
+            /// The offset for the next pread, or -1 to use read
+            off_t offset;
+            /// The buffer
+            aligned_buffer buffer;
+        };
+
+        /// A source of records obtained by splitting the blocks supplied by a
+        /// BlockReader. Records that lie within a single block are
+        /// std::string_views into that block; records that span blocks are
+        /// assembled in a separate buffer.
+        template <typename BlockReader> class basic_record_source {
+        public:
+            /// A sentinel marking the end of the records
+            class sentinel {};
+
+            /// An input iterator over the records
+            class iterator {
+            public:
+                /// Required iterator typedefs
+                using value_type= std::string_view;
+                /// Required iterator typedefs
+                using reference= std::string_view;
+                /// Required iterator typedefs
+                using iterator_category= std::input_iterator_tag;
+                /// Required iterator typedefs
+                using pointer= std::string_view const *;
+                /// Required iterator typedefs: cannot do std::distance on
+                /// input iterators
+                using difference_type= void;
+
+                /// The current record
+                std::string_view operator*() const noexcept {
+                    return source->current;
+                }
+
+                /// Access the current record
+                std::string_view const *operator->() const noexcept {
+                    return &source->current;
+                }
+
+                /// Move to the next record
+                iterator &operator++() {
+                    source->advance();
+                    return *this;
+                }
+
+                /// Move to the next record
+                detail::postinc_return<std::string_view> operator++(int) {
+                    detail::postinc_return<std::string_view> temp{**this};
+                    ++*this;
+                    return temp;
+                }
+
+                /// Is the iterator at the end?
+                friend bool
+                operator!=(iterator const &lhs, sentinel const &) noexcept {
+                    return !lhs.at_end();
+                }
+                /// Is the iterator at the end?
+                friend bool
+                operator==(iterator const &lhs, sentinel const &rhs) noexcept {
+                    return !(lhs != rhs);
+                }
+
+            private:
+                friend class basic_record_source;
+
+                explicit iterator(basic_record_source *source_) noexcept :
+                    source(source_) {}
+
+                /// Have all the records been consumed?
+                bool at_end() const noexcept {
+                    return source->exhausted;
+                }
+
+                /// The source
+                basic_record_source *source;
+            };
+
+            /// Get an iterator to the first record. This reads the first
+            /// block. As an input range, this can only be iterated once.
+            iterator begin() {
+                if(!started) {
+                    started= true;
+                    advance();
+                }
+                return iterator(this);
+            }
+
+            /// Get the sentinel for the end of the records
+            sentinel end() noexcept {
+                return sentinel();
+            }
+
+        protected:
+            /// Construct a source that splits the blocks from the reader
+            basic_record_source(record_format format_, BlockReader &&reader_) :
+                format(format_), reader(std::move(reader_)), block_pos(nullptr),
+                block_end(nullptr), carrying(false), started(false),
+                at_eof(false), exhausted(false) {}
+
+            /// The block reader
+            BlockReader const &get_reader() const noexcept {
+                return reader;
+            }
+
+        private:
+            /// Move to the next record, reading more blocks as required
+            void advance() {
+                if(carrying) {
+                    carry.clear();
+                    carrying= false;
+                }
+                for(;;) {
+                    size_t const available=
+                        static_cast<size_t>(block_end - block_pos);
+                    size_t length= available;
+                    bool complete= false;
+                    size_t skip= 0;
+                    if(format.is_delimited()) {
+                        char const *const found=
+                            available ? static_cast<char const *>(memchr(
+                                            block_pos, format.get_delimiter(),
+                                            available)) :
+                                        nullptr;
+                        if(found) {
+                            length= static_cast<size_t>(found - block_pos);
+                            complete= true;
+                            skip= 1;
+                        }
+                    } else {
+                        size_t const needed=
+                            format.get_record_size() - carry.size();
+                        if(available >= needed) {
+                            length= needed;
+                            complete= true;
+                        }
+                    }
+                    if(complete || (at_eof && (carrying || available))) {
+                        if(carrying) {
+                            carry.append(block_pos, length);
+                            current= std::string_view(carry);
+                        } else {
+                            current= std::string_view(block_pos, length);
+                        }
+                        block_pos+= length + skip;
+                        return;
+                    }
+                    if(at_eof) {
+                        current= std::string_view();
+                        exhausted= true;
+                        return;
+                    }
+                    if(available) {
+                        carry.append(block_pos, available);
+                        carrying= true;
+                    }
+                    std::string_view const block= reader.next_block();
+                    at_eof= block.empty();
+                    block_pos= block.data();
+                    block_end= block.data() + block.size();
+                }
+            }
+
+            /// The format of the records
+            record_format format;
+            /// The block reader
+            BlockReader reader;
+            /// The start of the unconsumed data in the current block
+            char const *block_pos;
+            /// The end of the current block
+            char const *block_end;
+            /// Storage for records that span blocks
+            std::string carry;
+            /// The current record
+            std::string_view current;
+            /// Is the current record being assembled in carry?
+            bool carrying;
+            /// Has begin() been called?
+            bool started;
+            /// Has the end of the file been reached?
+            bool at_eof;
+            /// Have all the records been consumed?
+            bool exhausted;
+        };
+    }
+
+    /// A source of records read from a file descriptor in large blocks. The
+    /// records are std::string_views into the internal buffer, so no data is
+    /// copied unless the user explicitly copies a record. Use with
+    /// jss::indexed_view to obtain the index of each record in the stream.
+    ///
+    /// This is an input range: the string_view for a record is only valid
+    /// until the iterator is incremented. The file descriptor is not owned by
+    /// the source.
+    class fd_record_source
+        : public detail::basic_record_source<detail::sync_block_reader> {
+    public:
+        /// The default size of each read
+        static constexpr size_t default_block_size= 1 << 20;
+        /// The alignment of the buffer that each read is performed into
+        static constexpr size_t buffer_alignment=
+            detail::aligned_buffer::alignment;
+
+        /// Read records from fd. If offset is -1 then the records are read
+        /// from the current file position with read(), so fd can be a pipe
+        /// or socket. Otherwise they are read from the specified offset with
+        /// pread(), and the file position is unchanged.
+        fd_record_source(
+            int fd, record_format format,
+            size_t block_size= default_block_size, off_t offset= -1) :
+            basic_record_source(
+                format,
+                detail::sync_block_reader(
+                    fd, block_size ? block_size : 1, offset)) {}
+    };
+
+    /// The mechanism used for asynchronous read-ahead
+    enum class read_ahead_backend {
+        /// Use io_uring if available, otherwise a background thread
+        automatic,
+        /// Use io_uring, failing if it is not available
+        io_uring,
+        /// Use a background thread performing pread()
+        threads
+    };
+
+    namespace detail {
+        /// A buffer used for one outstanding read
+        struct read_slot {
+            explicit read_slot(size_t block_size) :
+                buffer(block_size), offset(0), result(0), ready(false) {}
+
+            /// The buffer to read into
+            aligned_buffer buffer;
+            /// The file offset of the read
+            off_t offset;
+            /// The number of bytes read, or -errno on error
+            ssize_t result;
+            /// Has the read completed?
+            bool ready;
+        };
+
+        /// Performs reads with pread() on a background thread, in the order
+        /// they are submitted
+        class threaded_read_backend {
+        public:
+            /// Construct the backend and start the thread
+            threaded_read_backend(int fd_, read_slot *slots_) :
+                fd(fd_), slots(slots_), stop(false),
+                thread(&threaded_read_backend::thread_loop, this) {}
+
+            threaded_read_backend(threaded_read_backend const &)= delete;
+            threaded_read_backend &
+            operator=(threaded_read_backend const &)= delete;
+
+            /// Stop the thread once any read in progress completes
+            ~threaded_read_backend() {
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    stop= true;
+                }
+                cond.notify_all();
+                thread.join();
+            }
+
+            /// Queue a read of a block at the specified offset into the slot
+            void submit(size_t slot, off_t offset) {
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    slots[slot].offset= offset;
+                    slots[slot].ready= false;
+                    queue.push_back(slot);
+                }
+                cond.notify_all();
+            }
+
+            /// Wait for the read into the slot to complete
+            ssize_t wait(size_t slot) {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&] { return slots[slot].ready; });
+                return slots[slot].result;
+            }
+
+        private:
+            /// Process the queued reads
+            void thread_loop() {
+                std::unique_lock<std::mutex> lock(mutex);
+                for(;;) {
+                    cond.wait(lock, [this] { return stop || !queue.empty(); });
+                    if(stop)
+                        return;
+                    size_t const slot= queue.front();
+                    queue.pop_front();
+                    read_slot &target= slots[slot];
+                    lock.unlock();
+                    ssize_t result;
+                    do {
+                        result= ::pread(
+                            fd, target.buffer.data(), target.buffer.size(),
+                            target.offset);
+                    } while(result < 0 && errno == EINTR);
+                    if(result < 0)
+                        result= -errno;
+                    lock.lock();
+                    target.result= result;
+                    target.ready= true;
+                    cond.notify_all();
+                }
+            }
+
+            /// The file descriptor
+            int fd;
+            /// The slots
+            read_slot *slots;
+            /// Protect the queue and the slot states
+            std::mutex mutex;
+            /// Signal changes
+            std::condition_variable cond;
+            /// The queue of slots to read into
+            std::deque<size_t> queue;
+            /// Set to stop the thread
+            bool stop;
+            /// The background thread
+            std::thread thread;
+        };
+
+#ifdef JSS_INDEXED_VIEW_HAS_IO_URING
+        /// Performs reads with io_uring, using the raw system calls
+        class io_uring_read_backend {
+        public:
+            /// Set up a ring with enough entries for depth outstanding reads.
+            /// Returns nullptr if io_uring is not available
+            static std::unique_ptr<io_uring_read_backend>
+            create(int fd, read_slot *slots, unsigned depth) {
+                io_uring_params params;
+                memset(&params, 0, sizeof(params));
+                int const ring_fd= static_cast<int>(
+                    syscall(__NR_io_uring_setup, depth, &params));
+                if(ring_fd < 0)
+                    return nullptr;
+                std::unique_ptr<io_uring_read_backend> backend(
+                    new io_uring_read_backend(fd, slots, depth, ring_fd));
+                if(!backend->map_rings(params))
+                    return nullptr;
+                return backend;
+            }
+
+            io_uring_read_backend(io_uring_read_backend const &)= delete;
+            io_uring_read_backend &
+            operator=(io_uring_read_backend const &)= delete;
+
+            /// Wait for any outstanding reads, and release the ring
+            ~io_uring_read_backend() {
+                while(outstanding) {
+                    if(!reap_completions() && !enter(0, 1))
+                        break;
+                }
+                if(sqes)
+                    munmap(sqes, sqes_size);
+                if(cq_ring && (cq_ring != sq_ring))
+                    munmap(cq_ring, cq_ring_size);
+                if(sq_ring)
+                    munmap(sq_ring, sq_ring_size);
+                close(ring_fd);
+            }
+
+            /// Submit a read of a block at the specified offset into the
+            /// slot
+            void submit(size_t slot, off_t offset) {
+                read_slot &target= slots[slot];
+                target.offset= offset;
+                target.ready= false;
+                iovecs[slot].iov_base= target.buffer.data();
+                iovecs[slot].iov_len= target.buffer.size();
+
+                unsigned const tail= *sq_tail;
+                unsigned const index= tail & *sq_mask;
+                io_uring_sqe &sqe= sqes[index];
+                memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode= IORING_OP_READV;
+                sqe.fd= fd;
+                sqe.addr= reinterpret_cast<__u64>(&iovecs[slot]);
+                sqe.len= 1;
+                sqe.off= static_cast<__u64>(offset);
+                sqe.user_data= slot;
+                sq_array[index]= index;
+                __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+                ++outstanding;
+                if(!enter(1, 0))
+                    throw std::system_error(errno, std::generic_category());
+            }
+
+            /// Wait for the read into the slot to complete
+            ssize_t wait(size_t slot) {
+                while(!slots[slot].ready) {
+                    if(!reap_completions() && !enter(0, 1))
+                        throw std::system_error(
+                            errno, std::generic_category());
+                }
+                return slots[slot].result;
+            }
+
+        private:
+            io_uring_read_backend(
+                int fd_, read_slot *slots_, unsigned depth, int ring_fd_) :
+                fd(fd_),
+                slots(slots_), iovecs(depth), ring_fd(ring_fd_),
+                sq_ring(nullptr), cq_ring(nullptr), sqes(nullptr),
+                sq_ring_size(0), cq_ring_size(0), sqes_size(0),
+                outstanding(0) {}
+
+            /// Map the submission and completion rings into memory
+            bool map_rings(io_uring_params const &params) {
+                sq_ring_size=
+                    params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cq_ring_size= params.cq_off.cqes +
+                              params.cq_entries * sizeof(io_uring_cqe);
+                bool const single_mmap=
+                    (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if(single_mmap) {
+                    if(cq_ring_size > sq_ring_size)
+                        sq_ring_size= cq_ring_size;
+                    cq_ring_size= sq_ring_size;
+                }
+                sq_ring= map(sq_ring_size, IORING_OFF_SQ_RING);
+                if(!sq_ring)
+                    return false;
+                cq_ring= single_mmap ? sq_ring :
+                                       map(cq_ring_size, IORING_OFF_CQ_RING);
+                if(!cq_ring)
+                    return false;
+                sqes_size= params.sq_entries * sizeof(io_uring_sqe);
+                sqes= static_cast<io_uring_sqe *>(
+                    map(sqes_size, IORING_OFF_SQES));
+                if(!sqes)
+                    return false;
+
+                char *const sq= static_cast<char *>(sq_ring);
+                sq_tail= reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+                sq_mask=
+                    reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+                sq_array=
+                    reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+                char *const cq= static_cast<char *>(cq_ring);
+                cq_head= reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+                cq_tail= reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+                cq_mask=
+                    reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+                cqes= reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+                return true;
+            }
+
+            /// Map part of the ring
+            void *map(size_t size, off_t ring_offset) {
+                void *const result= mmap(
+                    nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd, ring_offset);
+                return result == MAP_FAILED ? nullptr : result;
+            }
+
+            /// Call io_uring_enter to submit entries and/or wait for
+            /// completions. Returns false on error
+            bool enter(unsigned to_submit, unsigned min_complete) {
+                for(;;) {
+                    long const result= syscall(
+                        __NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                        min_complete ? IORING_ENTER_GETEVENTS : 0u, nullptr,
+                        0);
+                    if(result >= 0)
+                        return true;
+                    if(errno != EINTR)
+                        return false;
+                }
+            }
+
+            /// Record the results of any completed reads. Returns true if
+            /// there were any
+            bool reap_completions() noexcept {
+                unsigned head= *cq_head;
+                unsigned const tail= __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+                if(head == tail)
+                    return false;
+                for(; head != tail; ++head) {
+                    io_uring_cqe const &cqe= cqes[head & *cq_mask];
+                    read_slot &target= slots[cqe.user_data];
+                    target.result= cqe.res;
+                    target.ready= true;
+                    --outstanding;
+                }
+                __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+                return true;
+            }
+
+            /// The file descriptor to read from
+            int fd;
+            /// The slots
+            read_slot *slots;
+            /// The iovec for each slot
+            std::vector<iovec> iovecs;
+            /// The io_uring file descriptor
+            int ring_fd;
+            /// The mapped submission ring
+            void *sq_ring;
+            /// The mapped completion ring
+            void *cq_ring;
+            /// The mapped submission queue entries
+            io_uring_sqe *sqes;
+            /// The size of the submission ring mapping
+            size_t sq_ring_size;
+            /// The size of the completion ring mapping
+            size_t cq_ring_size;
+            /// The size of the submission queue entries mapping
+            size_t sqes_size;
+            /// The submission ring tail
+            unsigned *sq_tail;
+            /// The submission ring mask
+            unsigned *sq_mask;
+            /// The submission ring index array
+            unsigned *sq_array;
+            /// The completion ring head
+            unsigned *cq_head;
+            /// The completion ring tail
+            unsigned *cq_tail;
+            /// The completion ring mask
+            unsigned *cq_mask;
+            /// The completion queue entries
+            io_uring_cqe *cqes;
+            /// The number of submitted reads not yet completed
+            unsigned outstanding;
+        };
+#endif
+
+        /// Reads blocks with a number of reads kept in flight ahead of the
+        /// block being processed. Blocks are returned in file order
+        class read_ahead_block_reader {
+        public:
+            /// Read blocks of block_size bytes from fd starting at offset,
+            /// with up to depth reads outstanding
+            read_ahead_block_reader(
+                int fd_, size_t block_size_, unsigned depth, off_t offset,
+                read_ahead_backend backend) :
+                fd(fd_),
+                block_size(block_size_), next_offset(offset), current_slot(0),
+                have_current(false), at_eof(false) {
+                if(!depth)
+                    depth= 1;
+                slots.reserve(depth);
+                for(unsigned i= 0; i < depth; ++i) {
+                    slots.emplace_back(block_size);
+                }
+#ifdef JSS_INDEXED_VIEW_HAS_IO_URING
+                if(backend != read_ahead_backend::threads) {
+                    uring_backend= io_uring_read_backend::create(
+                        fd, slots.data(), depth);
+                }
+#endif
+                if(!uring_backend) {
+                    if(backend == read_ahead_backend::io_uring)
+                        throw std::system_error(
+                            ENOSYS, std::generic_category(),
+                            "io_uring is not available");
+                    thread_backend.reset(
+                        new threaded_read_backend(fd, slots.data()));
+                }
+                for(size_t i= 0; i < slots.size(); ++i) {
+                    submit(i);
+                }
+            }
+
+            read_ahead_block_reader(read_ahead_block_reader &&)= default;
+            read_ahead_block_reader &
+            operator=(read_ahead_block_reader &&)= delete;
+
+            /// Is io_uring being used for the reads?
+            bool uses_io_uring() const noexcept {
+                return static_cast<bool>(uring_backend);
+            }
+
+            /// Get the next block. The previous block is no longer valid, and
+            /// its buffer is reused for a new read. An empty block indicates
+            /// the end of the file
+            std::string_view next_block() {
+                if(at_eof)
+                    return std::string_view();
+                if(have_current) {
+                    submit(current_slot);
+                    current_slot= (current_slot + 1) % slots.size();
+                }
+                have_current= true;
+                read_slot &slot= slots[current_slot];
+                ssize_t const result= wait(current_slot);
+                if(result < 0)
+                    throw std::system_error(
+                        static_cast<int>(-result), std::generic_category());
+                size_t size= static_cast<size_t>(result);
+                if(size && (size < block_size)) {
+                    size+= read_fully(
+                        fd, slot.buffer.data() + size, block_size - size,
+                        slot.offset + static_cast<off_t>(size));
+                }
+                if(size < block_size)
+                    at_eof= true;
+                return std::string_view(slot.buffer.data(), size);
+            }
+
+        private:
+            /// Submit a read of the next block into the specified slot
+            void submit(size_t slot) {
+#ifdef JSS_INDEXED_VIEW_HAS_IO_URING
+                if(uring_backend)
+                    uring_backend->submit(slot, next_offset);
+                else
+#endif
+                    thread_backend->submit(slot, next_offset);
+                next_offset+= static_cast<off_t>(block_size);
+            }
+
+            /// Wait for the read into the specified slot
+            ssize_t wait(size_t slot) {
+#ifdef JSS_INDEXED_VIEW_HAS_IO_URING
+                if(uring_backend)
+                    return uring_backend->wait(slot);
+#endif
+                return thread_backend->wait(slot);
+            }
+
+            /// The file descriptor
+            int fd;
+            /// The size of each block
+            size_t block_size;
+            /// The offset of the next block to submit
+            off_t next_offset;
+            /// The slot holding the current block
+            size_t current_slot;
+            /// Has a block been returned?
+            bool have_current;
+            /// Has the end of the file been reached?
+            bool at_eof;
+            /// The buffers for the outstanding reads. These must outlive the
+            /// backends
+            std::vector<read_slot> slots;
+#ifdef JSS_INDEXED_VIEW_HAS_IO_URING
+            /// The io_uring backend, if used
+            std::unique_ptr<io_uring_read_backend> uring_backend;
+#else
+            /// Placeholder when io_uring is not available
+            std::unique_ptr<threaded_read_backend> uring_backend;
+#endif
+            /// The thread backend, if used
+            std::unique_ptr<threaded_read_backend> thread_backend;
+        };
+    }
+
+    /// A source of records read from a file with asynchronous read-ahead.
+    /// Up to queue_depth reads of block_size bytes are kept in flight, so I/O
+    /// overlaps with processing the records in the current block. Reads use
+    /// io_uring if available, falling back to pread() on a background
+    /// thread. Records are returned in file order, as for fd_record_source.
+    ///
+    /// The file descriptor must refer to a file that supports pread(), and is
+    /// not owned by the source.
+    class async_fd_record_source
+        : public detail::basic_record_source<detail::read_ahead_block_reader> {
+    public:
+        /// The default size of each read
+        static constexpr size_t default_block_size= 1 << 20;
+        /// The default number of outstanding reads
+        static constexpr unsigned default_queue_depth= 4;
+
+        /// Read records from fd starting at offset
+        async_fd_record_source(
+            int fd, record_format format,
+            size_t block_size= default_block_size,
+            unsigned queue_depth= default_queue_depth, off_t offset= 0,
+            read_ahead_backend backend= read_ahead_backend::automatic) :
+            basic_record_source(
+                format, detail::read_ahead_block_reader(
+                            fd, block_size ? block_size : 1, queue_depth,
+                            offset, backend)) {}
+
+        /// Is io_uring being used for the reads?
+        bool uses_io_uring() const noexcept {
+            return get_reader().uses_io_uring();
+        }
+    };
+}
+
+#endif
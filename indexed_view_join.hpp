@@ -0,0 +1,264 @@
+#ifndef JSS_INDEXED_VIEW_JOIN_HPP
+#define JSS_INDEXED_VIEW_JOIN_HPP
+#include "indexed_view.hpp"
+#include "indexed_view_segmented.hpp"
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+
+namespace jss {
+    namespace detail {
+        /// Tag for iterating over a joined view an inner range at a time
+        struct join_iteration_tag {};
+
+        template <typename Iterator, typename Func>
+        void indexed_for_each_impl(
+            Iterator first, Iterator const &last, Func &func,
+            join_iteration_tag);
+
+        /// The iterator for an indexed_join_view_type. Each element has a
+        /// global index across all the inner ranges, as well as the index of
+        /// its inner range and its index within that range
+        template <typename OuterIterator, typename OuterSentinel>
+        class indexed_join_iterator {
+            /// The type of the inner ranges
+            using inner_range= decltype(*std::declval<OuterIterator &>());
+            /// The iterator type of the inner ranges
+            using inner_iterator=
+                decltype(std::begin(std::declval<inner_range>()));
+            /// The sentinel type of the inner ranges
+            using inner_sentinel=
+                decltype(std::end(std::declval<inner_range>()));
+            /// The type of dereferencing an inner iterator
+            using underlying_value_type=
+                decltype(*std::declval<inner_iterator &>());
+
+        public:
+            /// The value_type holds the indices and the value
+            struct value_type {
+                /// The index of the element across all the inner ranges
+                size_t global_index;
+                /// The index of the inner range in the outer range
+                size_t outer_index;
+                /// The index of the element in its inner range
+                size_t inner_index;
+                /// The element
+                underlying_value_type value;
+            };
+
+        private:
+            /// Proxy for ->
+            using arrow_proxy= detail::arrow_proxy<value_type>;
+            /// Proxy for handling *x++
+            using postinc_return= detail::postinc_return<value_type>;
+
+        public:
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs
+            using iterator_category= std::input_iterator_tag;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= void;
+
+            /// Compare iterators. An end iterator is equal to any iterator
+            /// that has run off the end of the outer range. Other iterators
+            /// are compared by global index
+            friend bool operator==(
+                indexed_join_iterator const &lhs,
+                indexed_join_iterator const &rhs) {
+                if(lhs.is_end || rhs.is_end)
+                    return lhs.at_end() == rhs.at_end();
+                return lhs.global_index == rhs.global_index;
+            }
+            /// Compare iterators
+            friend bool operator!=(
+                indexed_join_iterator const &lhs,
+                indexed_join_iterator const &rhs) {
+                return !(lhs == rhs);
+            }
+
+            /// Dereference the iterator
+            value_type operator*() const {
+                return value_type{global_index, outer_index, inner_index, *inner};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const {
+                return arrow_proxy{**this};
+            }
+
+            /// Pre-increment
+            indexed_join_iterator &operator++() {
+                ++global_index;
+                ++inner_index;
+                if(++inner == inner_end) {
+                    ++outer;
+                    ++outer_index;
+                    skip_empty_ranges();
+                }
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+        private:
+            template <typename, typename> friend class indexed_join_view_type;
+            template <typename Iterator, typename Func>
+            friend void indexed_for_each_impl(
+                Iterator first, Iterator const &last, Func &func,
+                join_iteration_tag);
+
+            /// Construct an iterator for the first element of the first
+            /// non-empty inner range from outer_, or an end iterator
+            indexed_join_iterator(
+                OuterIterator const &outer_, OuterSentinel const &outer_end_,
+                bool is_end_) :
+                outer(outer_),
+                outer_end(outer_end_), inner(), inner_end(), global_index(0),
+                outer_index(0), inner_index(0), is_end(is_end_) {
+                if(!is_end)
+                    skip_empty_ranges();
+            }
+
+            /// Has the iterator run off the end of the outer range?
+            bool at_end() const {
+                return is_end || (outer == outer_end);
+            }
+
+            /// Move to the first element of the next non-empty inner range,
+            /// starting from the current outer iterator
+            void skip_empty_ranges() {
+                inner_index= 0;
+                for(; outer != outer_end; ++outer, ++outer_index) {
+                    inner= std::begin(*outer);
+                    inner_end= std::end(*outer);
+                    if(inner != inner_end)
+                        return;
+                }
+            }
+
+            /// Process the rest of the elements, with a tight loop over each
+            /// inner range
+            template <typename Func> void for_each_remaining(Func &func) {
+                while(outer != outer_end) {
+                    size_t index= global_index;
+                    size_t local_index= inner_index;
+                    for(; inner != inner_end; ++inner) {
+                        func(value_type{
+                            index++, outer_index, local_index++, *inner});
+                    }
+                    global_index= index;
+                    ++outer;
+                    ++outer_index;
+                    skip_empty_ranges();
+                }
+            }
+
+            /// The current inner range
+            OuterIterator outer;
+            /// The end of the outer range
+            OuterSentinel outer_end;
+            /// The current element
+            inner_iterator inner;
+            /// The end of the current inner range
+            inner_sentinel inner_end;
+            /// The index across all the inner ranges
+            size_t global_index;
+            /// The index of the current inner range
+            size_t outer_index;
+            /// The index in the current inner range
+            size_t inner_index;
+            /// Is this the end iterator?
+            bool is_end;
+        };
+
+        /// A view that flattens a range of ranges. The outer range must
+        /// yield references to the inner ranges, so the inner iterators
+        /// remain valid.
+        template <typename OuterIterator, typename OuterSentinel>
+        class indexed_join_view_type {
+        public:
+            /// Construct a view from the iterator/sentinel pair for the
+            /// outer range
+            indexed_join_view_type(
+                OuterIterator &&begin_, OuterSentinel &&end_) :
+                outer_begin(std::move(begin_)),
+                outer_end(std::move(end_)) {}
+
+            /// The iterator for our range
+            using iterator= indexed_join_iterator<OuterIterator, OuterSentinel>;
+            /// The value_type of our range holds the indices and the value
+            using value_type= typename iterator::value_type;
+
+            /// Get an iterator for the first element of the first non-empty
+            /// inner range
+            iterator begin() {
+                return iterator(outer_begin, outer_end, false);
+            }
+
+            /// Get an iterator for the end of the range
+            iterator end() {
+                return iterator(outer_begin, outer_end, true);
+            }
+
+        private:
+            /// The start of the outer range
+            OuterIterator outer_begin;
+            /// The end of the outer range
+            OuterSentinel outer_end;
+        };
+
+        /// Joined views are processed by indexed_for_each an inner range at
+        /// a time
+        template <typename OuterIterator, typename OuterSentinel>
+        struct indexed_for_each_tag<
+            indexed_join_iterator<OuterIterator, OuterSentinel>> {
+            /// The tag type
+            using type= join_iteration_tag;
+        };
+
+        /// Call func for each element of a joined view, with a tight inner
+        /// loop over each inner range
+        template <typename Iterator, typename Func>
+        void indexed_for_each_impl(
+            Iterator first, Iterator const &last, Func &func,
+            join_iteration_tag) {
+            if(last.is_end) {
+                first.for_each_remaining(func);
+            } else {
+                for(; first != last; ++first) {
+                    func(*first);
+                }
+            }
+        }
+    }
+
+    /// Create a view over a range of ranges, such as a
+    /// std::vector<std::vector<T>>, which flattens the inner ranges into a
+    /// single sequence. Each element has a global_index across all the
+    /// inner ranges, the outer_index of its inner range, the inner_index of
+    /// the element within that range, and the value. Empty inner ranges are
+    /// skipped. The view refers to the source range, which must remain
+    /// valid while the view is used.
+    template <typename Outer>
+    detail::indexed_join_view_type<
+        decltype(std::begin(std::declval<Outer &>())),
+        decltype(std::end(std::declval<Outer &>()))>
+    indexed_join(Outer &outer) {
+        return detail::indexed_join_view_type<
+            decltype(std::begin(std::declval<Outer &>())),
+            decltype(std::end(std::declval<Outer &>()))>(
+            std::begin(outer), std::end(outer));
+    }
+}
+
+#endif
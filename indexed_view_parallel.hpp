@@ -0,0 +1,1588 @@
+#ifndef JSS_INDEXED_VIEW_PARALLEL_HPP
+#define JSS_INDEXED_VIEW_PARALLEL_HPP
+#include "indexed_view.hpp"
+#include "indexed_view_extrema.hpp"
+#include "indexed_view_where.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+namespace jss {
+    /// A simple pool of worker threads. Work is submitted through the
+    /// scheduler returned from get_scheduler()
+    class thread_pool {
+    public:
+        /// Construct a pool with the specified number of threads
+        explicit thread_pool(unsigned num_threads= default_thread_count()) :
+            done(false) {
+            if(!num_threads)
+                num_threads= 1;
+            threads.reserve(num_threads);
+            try {
+                for(unsigned i= 0; i < num_threads; ++i) {
+                    threads.emplace_back(&thread_pool::worker_loop, this);
+                }
+            } catch(...) {
+                stop();
+                throw;
+            }
+        }
+
+        thread_pool(thread_pool const &)= delete;
+        thread_pool &operator=(thread_pool const &)= delete;
+
+        /// Wait for all submitted work to complete, and then stop the threads
+        ~thread_pool() {
+            stop();
+        }
+
+        /// The number of worker threads
+        unsigned thread_count() const noexcept {
+            return static_cast<unsigned>(threads.size());
+        }
+
+        /// A scheduler for submitting work to the pool. Bulk work is split
+        /// into chunks by the scheduler, and the chunks are claimed
+        /// dynamically by the worker threads, so there is one submission per
+        /// worker rather than one per element
+        class scheduler {
+        public:
+            /// The number of chunks per worker thread for bulk work, to allow
+            /// for load balancing
+            static constexpr size_t chunks_per_thread= 4;
+
+            /// The number of worker threads
+            unsigned concurrency() const noexcept {
+                return pool->thread_count();
+            }
+
+            /// Split the index range [0,size) into chunks, and call
+            /// chunk_func(first,last) for each chunk on the worker threads.
+            /// Once all chunks have completed, call done() exactly once. Neither
+            /// chunk_func nor done may throw. If bulk_execute throws, then
+            /// done() has not been called, and will not be.
+            template <typename ChunkFunc, typename Done>
+            void
+            bulk_execute(size_t size, ChunkFunc chunk_func, Done done) const {
+                if(!size) {
+                    done();
+                    return;
+                }
+                size_t const max_chunks= concurrency() * chunks_per_thread;
+                size_t const chunks= size < max_chunks ? size : max_chunks;
+                auto state= std::make_shared<bulk_state<ChunkFunc, Done>>(
+                    size, chunks, std::move(chunk_func), std::move(done));
+                size_t const workers=
+                    chunks < concurrency() ? chunks : concurrency();
+                pool->submit([state] { state->run(); });
+                // The first worker claims every chunk that no other worker
+                // does, so it guarantees that done() is called. If queueing
+                // another worker fails, fewer threads share the chunks, and
+                // the failure must not be reported, as the caller would then
+                // complete the operation a second time
+                for(size_t i= 1; i < workers; ++i) {
+                    try {
+                        pool->submit([state] { state->run(); });
+                    } catch(...) {
+                        return;
+                    }
+                }
+            }
+
+            /// Schedulers compare equal if they submit to the same pool
+            friend bool
+            operator==(scheduler const &lhs, scheduler const &rhs) noexcept {
+                return lhs.pool == rhs.pool;
+            }
+            /// Schedulers compare equal if they submit to the same pool
+            friend bool
+            operator!=(scheduler const &lhs, scheduler const &rhs) noexcept {
+                return lhs.pool != rhs.pool;
+            }
+
+        private:
+            friend class thread_pool;
+
+            /// The shared state for a bulk submission
+            template <typename ChunkFunc, typename Done> struct bulk_state {
+                bulk_state(
+                    size_t size_, size_t chunks_, ChunkFunc &&chunk_func_,
+                    Done &&done_) :
+                    size(size_),
+                    chunks(chunks_), next_chunk(0), remaining(chunks_),
+                    chunk_func(std::move(chunk_func_)),
+                    done(std::move(done_)) {}
+
+                /// Claim and run chunks until there are none left
+                void run() {
+                    size_t const chunk_size= size / chunks;
+                    size_t const extra= size % chunks;
+                    for(;;) {
+                        size_t const chunk=
+                            next_chunk.fetch_add(1, std::memory_order_relaxed);
+                        if(chunk >= chunks)
+                            return;
+                        size_t const first=
+                            chunk * chunk_size + (chunk < extra ? chunk : extra);
+                        size_t const last=
+                            first + chunk_size + (chunk < extra ? 1 : 0);
+                        chunk_func(first, last);
+                        if(remaining.fetch_sub(1, std::memory_order_acq_rel) ==
+                           1) {
+                            done();
+                        }
+                    }
+                }
+
+                /// The total number of indices
+                size_t const size;
+                /// The number of chunks
+                size_t const chunks;
+                /// The next chunk to claim
+                std::atomic<size_t> next_chunk;
+                /// The number of chunks not yet completed
+                std::atomic<size_t> remaining;
+                /// The function to run for each chunk
+                ChunkFunc chunk_func;
+                /// The function to run on completion
+                Done done;
+            };
+
+            explicit scheduler(thread_pool *pool_) noexcept : pool(pool_) {}
+
+            /// The pool
+            thread_pool *pool;
+        };
+
+        /// Get a scheduler for this pool
+        scheduler get_scheduler() noexcept {
+            return scheduler(this);
+        }
+
+    private:
+        /// The default number of threads
+        static unsigned default_thread_count() noexcept {
+            unsigned const count= std::thread::hardware_concurrency();
+            return count ? count : 1;
+        }
+
+        /// Add a task to the queue
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                tasks.push_back(std::move(task));
+            }
+            cond.notify_one();
+        }
+
+        /// The main loop for the worker threads
+        void worker_loop() {
+            for(;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [this] { return done || !tasks.empty(); });
+                    if(tasks.empty())
+                        return;
+                    task= std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        /// Tell the threads to stop once the queue is empty, and wait for
+        /// them
+        void stop() noexcept {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                done= true;
+            }
+            cond.notify_all();
+            for(auto &thread : threads) {
+                thread.join();
+            }
+        }
+
+        /// Protect the queue
+        std::mutex mutex;
+        /// Signal changes to the queue
+        std::condition_variable cond;
+        /// The queue of tasks
+        std::deque<std::function<void()>> tasks;
+        /// Set when the pool is being destroyed
+        bool done;
+        /// The worker threads
+        std::vector<std::thread> threads;
+    };
+
+    /// The exception thrown when an operation is stopped by a
+    /// cancellation_token before all the elements have been processed
+    class operation_cancelled : public std::exception {
+    public:
+        /// The description of the exception
+        char const *what() const noexcept override {
+            return "operation cancelled";
+        }
+    };
+
+    /// The exception thrown when the function for a parallel indexed
+    /// algorithm throws. The original exception is nested, so it can be
+    /// rethrown with std::rethrow_if_nested, and index() is the index of the
+    /// element being processed when it was thrown.
+    class indexed_exception : public std::exception,
+                              public std::nested_exception {
+    public:
+        /// Construct an exception for the element with the specified index,
+        /// which nests the exception currently being handled
+        explicit indexed_exception(size_t index_) noexcept :
+            failed_index(index_) {}
+
+        /// The index of the element
+        size_t index() const noexcept {
+            return failed_index;
+        }
+
+        /// The description of the exception
+        char const *what() const noexcept override {
+            return "exception thrown while processing an indexed element";
+        }
+
+    private:
+        /// The index of the element
+        size_t failed_index;
+    };
+
+    /// A flag for cooperative cancellation. The parallel indexed algorithms
+    /// check the flag before each block of elements, and stop processing
+    /// once it is set. The first exception thrown by the function for an
+    /// algorithm also sets the flag. Sequential loops can poll the same
+    /// token, as checking it is a single relaxed load.
+    class cancellation_token {
+    public:
+        /// Construct a token that has not been cancelled
+        cancellation_token() noexcept : cancelled(false) {}
+
+        cancellation_token(cancellation_token const &)= delete;
+        cancellation_token &operator=(cancellation_token const &)= delete;
+
+        /// Request cancellation
+        void cancel() noexcept {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        /// Has cancellation been requested?
+        bool is_cancelled() const noexcept {
+            return cancelled.load(std::memory_order_relaxed);
+        }
+
+        /// Throw operation_cancelled if cancellation has been requested
+        void throw_if_cancelled() const {
+            if(is_cancelled())
+                throw operation_cancelled();
+        }
+
+    private:
+        /// Set when cancellation has been requested
+        std::atomic<bool> cancelled;
+    };
+
+    /// The partial result for an element of an indexed scan: the index of
+    /// the element, and the combination of the initial value with the
+    /// elements up to it
+    template <typename T> struct indexed_scan_result {
+        size_t index;
+        T value;
+    };
+
+    namespace detail {
+        /// The number of elements processed between checks of the
+        /// cancellation token
+        constexpr size_t cancellation_check_interval= 1024;
+
+        /// Does the view have random-access iterators, so it can be split
+        /// into chunks?
+        template <typename View>
+        using has_random_access_iterators= is_random_access_iterator<
+            decltype(std::declval<View &>().begin())>;
+
+        /// The operation state for a bulk_indexed operation. The scheduler
+        /// splits the view into chunks, and func is called for each element
+        /// with the global index. The receiver is notified with set_value()
+        /// when all elements have been processed, or set_error() with the
+        /// first exception thrown, wrapped in an indexed_exception, or with
+        /// operation_cancelled if the token was cancelled
+        template <
+            typename Scheduler, typename View, typename Func,
+            typename Receiver>
+        class bulk_indexed_operation {
+        public:
+            /// Construct the operation state. If token_ is null, the
+            /// operation uses its own token
+            bulk_indexed_operation(
+                Scheduler scheduler_, View view_, Func func_,
+                Receiver receiver_, cancellation_token *token_) :
+                scheduler(std::move(scheduler_)),
+                view(std::move(view_)), func(std::move(func_)),
+                receiver(std::move(receiver_)),
+                token(token_ ? token_ : &own_token), failed(false),
+                skipped(false) {}
+
+            bulk_indexed_operation(bulk_indexed_operation const &)= delete;
+            bulk_indexed_operation &
+            operator=(bulk_indexed_operation const &)= delete;
+
+            /// Submit the work to the scheduler. If bulk_execute throws, it
+            /// has not called done(), and will not, so the receiver is only
+            /// notified of the exception
+            void start() noexcept {
+                try {
+                    // The operation may complete before bulk_execute returns,
+                    // so use a local copy of the scheduler
+                    Scheduler local_scheduler(scheduler);
+                    local_scheduler.bulk_execute(
+                        shape(has_random_access_iterators<View>()),
+                        [this](size_t first, size_t last) noexcept {
+                            run_chunk(
+                                first, last,
+                                has_random_access_iterators<View>());
+                        },
+                        [this]() noexcept { complete(); });
+                } catch(...) {
+                    receiver.set_error(std::current_exception());
+                }
+            }
+
+        private:
+            /// For random-access views the scheduler can split the elements
+            size_t shape(std::true_type) {
+                return static_cast<size_t>(view.end() - view.begin());
+            }
+            /// Other views are processed as a single chunk
+            size_t shape(std::false_type) {
+                return 1;
+            }
+
+            /// Process the elements in the chunk [first,last), checking the
+            /// token before each block of elements
+            void
+            run_chunk(size_t first, size_t last, std::true_type) noexcept {
+                auto const start= view.begin();
+                auto it= start;
+                try {
+                    while(first != last) {
+                        if(token->is_cancelled()) {
+                            skipped.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                        size_t const block_end=
+                            last - first > cancellation_check_interval ?
+                                first + cancellation_check_interval :
+                                last;
+                        it= start + static_cast<ptrdiff_t>(first);
+                        auto const end=
+                            start + static_cast<ptrdiff_t>(block_end);
+                        for(; it != end; ++it) {
+                            func(*it);
+                        }
+                        first= block_end;
+                    }
+                } catch(...) {
+                    record_error((*it).index);
+                }
+            }
+
+            /// Process all the elements sequentially
+            void run_chunk(size_t, size_t, std::false_type) noexcept {
+                size_t index= 0;
+                try {
+                    size_t count= 0;
+                    for(auto &&entry : view) {
+                        if(!(count++ % cancellation_check_interval) &&
+                           token->is_cancelled()) {
+                            skipped.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                        index= entry.index;
+                        func(entry);
+                    }
+                } catch(...) {
+                    record_error(index);
+                }
+            }
+
+            /// Record the first exception, and cancel the remaining work.
+            /// Must be called from a catch block
+            void record_error(size_t index) noexcept {
+                token->cancel();
+                if(!failed.exchange(true, std::memory_order_relaxed)) {
+                    error= std::make_exception_ptr(indexed_exception(index));
+                }
+            }
+
+            /// Notify the receiver
+            void complete() noexcept {
+                if(error) {
+                    receiver.set_error(std::move(error));
+                } else if(skipped.load(std::memory_order_relaxed)) {
+                    receiver.set_error(
+                        std::make_exception_ptr(operation_cancelled()));
+                } else {
+                    receiver.set_value();
+                }
+            }
+
+            /// The scheduler
+            Scheduler scheduler;
+            /// The view to process
+            View view;
+            /// The function to call for each element
+            Func func;
+            /// The receiver to notify on completion
+            Receiver receiver;
+            /// The token used if none is supplied
+            cancellation_token own_token;
+            /// The token to check for cancellation
+            cancellation_token *token;
+            /// Set if an exception has been thrown
+            std::atomic<bool> failed;
+            /// Set if any elements were skipped due to cancellation
+            std::atomic<bool> skipped;
+            /// The first exception thrown
+            std::exception_ptr error;
+        };
+
+        /// A sender representing a bulk operation over an indexed view
+        template <typename Scheduler, typename View, typename Func>
+        class bulk_indexed_sender {
+        public:
+            /// Construct the sender
+            bulk_indexed_sender(
+                Scheduler scheduler_, View view_, Func func_,
+                cancellation_token *token_) :
+                scheduler(std::move(scheduler_)),
+                view(std::move(view_)), func(std::move(func_)), token(token_) {}
+
+            /// Connect the sender to a receiver, to obtain an operation state
+            template <typename Receiver>
+            bulk_indexed_operation<Scheduler, View, Func, Receiver>
+            connect(Receiver receiver) && {
+                return bulk_indexed_operation<Scheduler, View, Func, Receiver>(
+                    std::move(scheduler), std::move(view), std::move(func),
+                    std::move(receiver), token);
+            }
+
+            /// Connect the sender to a receiver, to obtain an operation state
+            template <typename Receiver>
+            bulk_indexed_operation<Scheduler, View, Func, Receiver>
+            connect(Receiver receiver) const & {
+                return bulk_indexed_operation<Scheduler, View, Func, Receiver>(
+                    scheduler, view, func, std::move(receiver), token);
+            }
+
+        private:
+            /// The scheduler
+            Scheduler scheduler;
+            /// The view to process
+            View view;
+            /// The function to call for each element
+            Func func;
+            /// The cancellation token, if any
+            cancellation_token *token;
+        };
+
+        /// The operation state for a bulk_indexed_buckets operation. The
+        /// buckets of the container are divided into groups. The elements in
+        /// each group are counted concurrently, an exclusive prefix sum of
+        /// the counts gives the base index of each group, and then the groups
+        /// are processed concurrently, numbering the elements in each group
+        /// from its base index. Errors and cancellation are reported as for
+        /// bulk_indexed_operation
+        template <
+            typename Scheduler, typename Container, typename Func,
+            typename Receiver>
+        class bulk_indexed_buckets_operation {
+            /// The iterator for a single bucket
+            using local_iterator=
+                decltype(std::declval<Container &>().begin(size_t()));
+
+        public:
+            /// The number of buckets in each group
+            static constexpr size_t buckets_per_group= 64;
+
+            /// The value passed to func: the index and the element
+            struct value_type {
+                size_t index;
+                decltype(*std::declval<local_iterator &>()) value;
+            };
+
+            /// Construct the operation state. If token_ is null, the
+            /// operation uses its own token
+            bulk_indexed_buckets_operation(
+                Scheduler scheduler_, Container &container_, Func func_,
+                Receiver receiver_, cancellation_token *token_) :
+                scheduler(std::move(scheduler_)),
+                container(&container_), func(std::move(func_)),
+                receiver(std::move(receiver_)),
+                token(token_ ? token_ : &own_token), failed(false),
+                skipped(false) {}
+
+            bulk_indexed_buckets_operation(
+                bulk_indexed_buckets_operation const &)= delete;
+            bulk_indexed_buckets_operation &
+            operator=(bulk_indexed_buckets_operation const &)= delete;
+
+            /// Submit the counting phase to the scheduler. As for
+            /// bulk_indexed_operation, a scheduler that throws has not
+            /// called done()
+            void start() noexcept {
+                try {
+                    size_t const buckets= container->bucket_count();
+                    size_t const groups=
+                        (buckets + buckets_per_group - 1) / buckets_per_group;
+                    base_indices.assign(groups, 0);
+                    // The operation may complete before bulk_execute returns,
+                    // so use a local copy of the scheduler
+                    Scheduler local_scheduler(scheduler);
+                    local_scheduler.bulk_execute(
+                        groups,
+                        [this](size_t first, size_t last) noexcept {
+                            count_groups(first, last);
+                        },
+                        [this]() noexcept { start_processing(); });
+                } catch(...) {
+                    receiver.set_error(std::current_exception());
+                }
+            }
+
+        private:
+            /// The buckets in the specified group
+            void group_buckets(
+                size_t group, size_t &first, size_t &last) const noexcept {
+                size_t const buckets= container->bucket_count();
+                first= group * buckets_per_group;
+                last= first + buckets_per_group;
+                if(last > buckets)
+                    last= buckets;
+            }
+
+            /// Count the elements in the groups [first,last)
+            void count_groups(size_t first, size_t last) noexcept {
+                for(size_t group= first; group != last; ++group) {
+                    size_t first_bucket, last_bucket;
+                    group_buckets(group, first_bucket, last_bucket);
+                    size_t count= 0;
+                    for(size_t b= first_bucket; b != last_bucket; ++b) {
+                        count+= container->bucket_size(b);
+                    }
+                    base_indices[group]= count;
+                }
+            }
+
+            /// Turn the counts into base indices, and submit the processing
+            /// phase to the scheduler
+            void start_processing() noexcept {
+                size_t total= 0;
+                for(auto &base : base_indices) {
+                    size_t const count= base;
+                    base= total;
+                    total+= count;
+                }
+                try {
+                    // The operation may complete before bulk_execute returns,
+                    // so use a local copy of the scheduler
+                    Scheduler local_scheduler(scheduler);
+                    local_scheduler.bulk_execute(
+                        base_indices.size(),
+                        [this](size_t first, size_t last) noexcept {
+                            process_groups(first, last);
+                        },
+                        [this]() noexcept { complete(); });
+                } catch(...) {
+                    receiver.set_error(std::current_exception());
+                }
+            }
+
+            /// Process the elements in the groups [first,last), checking the
+            /// token before each group
+            void process_groups(size_t first, size_t last) noexcept {
+                size_t index= 0;
+                try {
+                    for(size_t group= first; group != last; ++group) {
+                        if(token->is_cancelled()) {
+                            skipped.store(true, std::memory_order_relaxed);
+                            return;
+                        }
+                        size_t first_bucket, last_bucket;
+                        group_buckets(group, first_bucket, last_bucket);
+                        index= base_indices[group];
+                        for(size_t b= first_bucket; b != last_bucket; ++b) {
+                            auto const end= container->end(b);
+                            for(auto it= container->begin(b); it != end;
+                                ++it, ++index) {
+                                func(value_type{index, *it});
+                            }
+                        }
+                    }
+                } catch(...) {
+                    record_error(index);
+                }
+            }
+
+            /// Record the first exception, and cancel the remaining work.
+            /// Must be called from a catch block
+            void record_error(size_t index) noexcept {
+                token->cancel();
+                if(!failed.exchange(true, std::memory_order_relaxed)) {
+                    error= std::make_exception_ptr(indexed_exception(index));
+                }
+            }
+
+            /// Notify the receiver
+            void complete() noexcept {
+                if(error) {
+                    receiver.set_error(std::move(error));
+                } else if(skipped.load(std::memory_order_relaxed)) {
+                    receiver.set_error(
+                        std::make_exception_ptr(operation_cancelled()));
+                } else {
+                    receiver.set_value();
+                }
+            }
+
+            /// The scheduler
+            Scheduler scheduler;
+            /// The container to process
+            Container *container;
+            /// The function to call for each element
+            Func func;
+            /// The receiver to notify on completion
+            Receiver receiver;
+            /// The element count, and then the base index, of each group
+            std::vector<size_t> base_indices;
+            /// The token used if none is supplied
+            cancellation_token own_token;
+            /// The token to check for cancellation
+            cancellation_token *token;
+            /// Set if an exception has been thrown
+            std::atomic<bool> failed;
+            /// Set if any elements were skipped due to cancellation
+            std::atomic<bool> skipped;
+            /// The first exception thrown
+            std::exception_ptr error;
+        };
+
+        /// A sender representing a bulk operation over the buckets of an
+        /// unordered container
+        template <typename Scheduler, typename Container, typename Func>
+        class bulk_indexed_buckets_sender {
+        public:
+            /// Construct the sender
+            bulk_indexed_buckets_sender(
+                Scheduler scheduler_, Container &container_, Func func_,
+                cancellation_token *token_) :
+                scheduler(std::move(scheduler_)),
+                container(&container_), func(std::move(func_)), token(token_) {}
+
+            /// Connect the sender to a receiver, to obtain an operation state
+            template <typename Receiver>
+            bulk_indexed_buckets_operation<
+                Scheduler, Container, Func, Receiver>
+            connect(Receiver receiver) && {
+                return bulk_indexed_buckets_operation<
+                    Scheduler, Container, Func, Receiver>(
+                    std::move(scheduler), *container, std::move(func),
+                    std::move(receiver), token);
+            }
+
+            /// Connect the sender to a receiver, to obtain an operation state
+            template <typename Receiver>
+            bulk_indexed_buckets_operation<
+                Scheduler, Container, Func, Receiver>
+            connect(Receiver receiver) const & {
+                return bulk_indexed_buckets_operation<
+                    Scheduler, Container, Func, Receiver>(
+                    scheduler, *container, func, std::move(receiver), token);
+            }
+
+        private:
+            /// The scheduler
+            Scheduler scheduler;
+            /// The container to process
+            Container *container;
+            /// The function to call for each element
+            Func func;
+            /// The cancellation token, if any
+            cancellation_token *token;
+        };
+
+        /// The shared state for sync_wait
+        struct sync_wait_state {
+            /// Protect the state
+            std::mutex mutex;
+            /// Signal completion
+            std::condition_variable cond;
+            /// Set on completion
+            bool done= false;
+            /// The exception to rethrow, if any
+            std::exception_ptr error;
+
+            /// Mark the operation as complete
+            void complete(std::exception_ptr e) noexcept {
+                std::lock_guard<std::mutex> guard(mutex);
+                error= std::move(e);
+                done= true;
+                cond.notify_all();
+            }
+        };
+
+        /// The receiver used by sync_wait
+        class sync_wait_receiver {
+        public:
+            explicit sync_wait_receiver(sync_wait_state &state_) noexcept :
+                state(&state_) {}
+
+            /// The operation completed successfully
+            void set_value() noexcept {
+                state->complete(nullptr);
+            }
+            /// The operation completed with an exception
+            void set_error(std::exception_ptr e) noexcept {
+                state->complete(std::move(e));
+            }
+
+        private:
+            /// The state to notify
+            sync_wait_state *state;
+        };
+
+        /// Call scheduler.bulk_execute(size,chunk_func,done), and wait for
+        /// all the chunks to complete. Must not be called from a thread that
+        /// is needed to run the chunks.
+        template <typename Scheduler, typename ChunkFunc>
+        void bulk_execute_and_wait(
+            Scheduler const &scheduler, size_t size, ChunkFunc chunk_func) {
+            sync_wait_state state;
+            scheduler.bulk_execute(
+                size, std::move(chunk_func),
+                [&state]() noexcept { state.complete(nullptr); });
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.cond.wait(lock, [&] { return state.done; });
+        }
+
+        /// The first exception thrown by the chunks of a parallel algorithm
+        class first_exception {
+        public:
+            first_exception() noexcept : failed(false) {}
+
+            /// Has an exception been recorded?
+            bool has_failed() const noexcept {
+                return failed.load(std::memory_order_relaxed);
+            }
+
+            /// Record the exception currently being handled, thrown while
+            /// processing the element with the specified index, if it is
+            /// the first. Must be called from a catch block
+            void record(size_t index) noexcept {
+                if(!failed.exchange(true, std::memory_order_relaxed)) {
+                    error= std::make_exception_ptr(indexed_exception(index));
+                }
+            }
+
+            /// Rethrow the recorded exception, if any
+            void rethrow_if_failed() const {
+                if(error)
+                    std::rethrow_exception(error);
+            }
+
+        private:
+            /// Set when an exception has been recorded
+            std::atomic<bool> failed;
+            /// The recorded exception
+            std::exception_ptr error;
+        };
+
+        /// Reduce value to new_value, if new_value is smaller
+        inline void atomic_fetch_min(
+            std::atomic<size_t> &value, size_t new_value) noexcept {
+            size_t current= value.load(std::memory_order_relaxed);
+            while((new_value < current) &&
+                  !value.compare_exchange_weak(
+                      current, new_value, std::memory_order_relaxed)) {
+            }
+        }
+
+        /// Find the first matching element of a random-access view. Each
+        /// chunk is scanned a block at a time, and stops once a lower
+        /// matching element has been found
+        template <typename Scheduler, typename View, typename Predicate>
+        std::optional<size_t> find_first_index_impl(
+            Scheduler const &scheduler, View &view, Predicate &pred,
+            std::true_type) {
+            auto const start= view.begin();
+            size_t const size= static_cast<size_t>(view.end() - start);
+            std::atomic<size_t> best(size);
+            first_exception errors;
+            bulk_execute_and_wait(
+                scheduler, size, [&](size_t first, size_t last) noexcept {
+                    auto it= start;
+                    try {
+                        while(first != last) {
+                            if(errors.has_failed() ||
+                               (best.load(std::memory_order_relaxed) <= first))
+                                return;
+                            size_t const block_end=
+                                last - first > cancellation_check_interval ?
+                                    first + cancellation_check_interval :
+                                    last;
+                            it= start + static_cast<ptrdiff_t>(first);
+                            auto const end=
+                                start + static_cast<ptrdiff_t>(block_end);
+                            for(; it != end; ++it) {
+                                if(pred(*it)) {
+                                    atomic_fetch_min(
+                                        best, static_cast<size_t>(it - start));
+                                    return;
+                                }
+                            }
+                            first= block_end;
+                        }
+                    } catch(...) {
+                        errors.record((*it).index);
+                    }
+                });
+            errors.rethrow_if_failed();
+            size_t const offset= best.load(std::memory_order_relaxed);
+            if(offset == size)
+                return std::nullopt;
+            return (*(start + static_cast<ptrdiff_t>(offset))).index;
+        }
+
+        /// The number of elements in each block of a parallel scan
+        constexpr size_t scan_block_size= 16384;
+
+        /// Tag for an inclusive scan
+        struct inclusive_scan_tag {};
+        /// Tag for an exclusive scan
+        struct exclusive_scan_tag {};
+
+        /// Write the partial results for the elements of a block
+        /// [first,last), starting from running, which is the combination of
+        /// init and the preceding elements. If op throws, first refers to
+        /// the element being processed
+        template <
+            typename Iterator, typename OutputIterator, typename T,
+            typename BinaryOp>
+        void scan_block(
+            Iterator &first, Iterator const &last, OutputIterator out,
+            T running, BinaryOp &op, inclusive_scan_tag) {
+            for(; first != last; ++first, ++out) {
+                auto &&element= *first;
+                running= op(std::move(running), element.value);
+                *out= indexed_scan_result<T>{element.index, running};
+            }
+        }
+
+        /// Write the partial results for the elements of a block
+        /// [first,last), starting from running, which is the combination of
+        /// init and the preceding elements. If op throws, first refers to
+        /// the element being processed
+        template <
+            typename Iterator, typename OutputIterator, typename T,
+            typename BinaryOp>
+        void scan_block(
+            Iterator &first, Iterator const &last, OutputIterator out,
+            T running, BinaryOp &op, exclusive_scan_tag) {
+            for(; first != last; ++first, ++out) {
+                auto &&element= *first;
+                *out= indexed_scan_result<T>{element.index, running};
+                running= op(std::move(running), element.value);
+            }
+        }
+
+        /// Run a two-pass parallel scan over a random-access view. The view
+        /// is divided into blocks of scan_block_size elements. The first
+        /// pass combines the elements of each block except the last
+        /// concurrently, a serial scan of the block totals gives the
+        /// starting value for each block, and the second pass writes the
+        /// partial results for each block concurrently
+        template <
+            typename Scheduler, typename View, typename RandomAccessIterator,
+            typename T, typename BinaryOp, typename Tag>
+        RandomAccessIterator indexed_scan(
+            Scheduler const &scheduler, View &view, RandomAccessIterator out,
+            T init, BinaryOp &op, Tag tag) {
+            static_assert(
+                has_random_access_iterators<View>::value,
+                "Parallel scans require views with random-access iterators");
+            static_assert(
+                is_random_access_iterator<RandomAccessIterator>::value,
+                "Parallel scans write each block of results to its own part "
+                "of the output, so require a random-access output iterator");
+            auto const start= view.begin();
+            size_t const size= static_cast<size_t>(view.end() - start);
+            size_t const blocks= (size + scan_block_size - 1) / scan_block_size;
+            if(blocks < 2) {
+                auto it= start;
+                try {
+                    scan_block(it, view.end(), out, std::move(init), op, tag);
+                } catch(...) {
+                    throw indexed_exception((*it).index);
+                }
+                return out + static_cast<ptrdiff_t>(size);
+            }
+
+            std::vector<T> block_starts(blocks, init);
+            first_exception errors;
+            bulk_execute_and_wait(
+                scheduler, blocks - 1,
+                [&](size_t first, size_t last) noexcept {
+                    size_t offset= first * scan_block_size;
+                    try {
+                        for(size_t block= first; block != last; ++block) {
+                            auto it= start + static_cast<ptrdiff_t>(offset);
+                            T total= (*it).value;
+                            size_t const block_end= offset + scan_block_size;
+                            for(++offset; offset != block_end; ++offset) {
+                                total= op(
+                                    std::move(total),
+                                    (*(start + static_cast<ptrdiff_t>(offset)))
+                                        .value);
+                            }
+                            block_starts[block + 1]= std::move(total);
+                        }
+                    } catch(...) {
+                        errors.record(
+                            (*(start + static_cast<ptrdiff_t>(offset))).index);
+                    }
+                });
+            errors.rethrow_if_failed();
+
+            for(size_t block= 1; block != blocks; ++block) {
+                block_starts[block]= op(
+                    block_starts[block - 1], std::move(block_starts[block]));
+            }
+
+            bulk_execute_and_wait(
+                scheduler, blocks, [&](size_t first, size_t last) noexcept {
+                    auto it= start;
+                    try {
+                        for(size_t block= first; block != last; ++block) {
+                            size_t const offset= block * scan_block_size;
+                            size_t const block_end=
+                                size - offset > scan_block_size ?
+                                    offset + scan_block_size :
+                                    size;
+                            it= start + static_cast<ptrdiff_t>(offset);
+                            scan_block(
+                                it, start + static_cast<ptrdiff_t>(block_end),
+                                out + static_cast<ptrdiff_t>(offset),
+                                block_starts[block], op, tag);
+                        }
+                    } catch(...) {
+                        errors.record((*it).index);
+                    }
+                });
+            errors.rethrow_if_failed();
+            return out + static_cast<ptrdiff_t>(size);
+        }
+
+        /// The number of elements in each leaf of the reduction tree for a
+        /// parallel reduction
+        constexpr size_t reduce_block_size= 4096;
+
+        /// Reduce a view with random-access iterators with a fixed tree. The
+        /// view is divided into blocks of reduce_block_size elements, which
+        /// are reduced concurrently in index order. Adjacent pairs of block
+        /// results are then combined repeatedly until there is only one. The
+        /// shape of the tree depends only on the size of the view, so the
+        /// result does not depend on the number of threads
+        template <
+            typename Scheduler, typename View, typename T, typename BinaryOp>
+        T indexed_reduce_impl(
+            Scheduler const &scheduler, View &view, T init, BinaryOp &op,
+            std::true_type) {
+            auto const start= view.begin();
+            size_t const size= static_cast<size_t>(view.end() - start);
+            if(!size)
+                return init;
+            size_t const blocks=
+                (size + reduce_block_size - 1) / reduce_block_size;
+
+            std::vector<T> results(blocks, init);
+            first_exception errors;
+            auto reduce_blocks= [&](size_t first, size_t last) noexcept {
+                auto it= start;
+                try {
+                    for(size_t block= first; block != last; ++block) {
+                        size_t const offset= block * reduce_block_size;
+                        size_t const block_end=
+                            size - offset > reduce_block_size ?
+                                offset + reduce_block_size :
+                                size;
+                        it= start + static_cast<ptrdiff_t>(offset);
+                        auto const end=
+                            start + static_cast<ptrdiff_t>(block_end);
+                        T total= (*it).value;
+                        for(++it; it != end; ++it) {
+                            total= op(std::move(total), (*it).value);
+                        }
+                        results[block]= std::move(total);
+                    }
+                } catch(...) {
+                    errors.record((*it).index);
+                }
+            };
+            if(blocks == 1) {
+                reduce_blocks(0, 1);
+            } else {
+                bulk_execute_and_wait(scheduler, blocks, reduce_blocks);
+            }
+            errors.rethrow_if_failed();
+
+            for(size_t count= blocks; count > 1; count= (count + 1) / 2) {
+                for(size_t i= 0; i + 1 < count; i+= 2) {
+                    results[i / 2]=
+                        op(std::move(results[i]), std::move(results[i + 1]));
+                }
+                if(count % 2)
+                    results[count / 2]= std::move(results[count - 1]);
+            }
+            return op(std::move(init), std::move(results[0]));
+        }
+
+        /// Reduce any other view sequentially, in index order
+        template <
+            typename Scheduler, typename View, typename T, typename BinaryOp>
+        T indexed_reduce_impl(
+            Scheduler const &, View &view, T init, BinaryOp &op,
+            std::false_type) {
+            size_t index= 0;
+            try {
+                for(auto &&entry : view) {
+                    index= entry.index;
+                    init= op(std::move(init), entry.value);
+                }
+            } catch(...) {
+                throw indexed_exception(index);
+            }
+            return init;
+        }
+
+        /// Call func with an element_tracker on the calling thread. If func
+        /// throws, the exception is rethrown wrapped in an indexed_exception
+        /// that holds the index of the element being processed
+        template <typename Func> auto with_element_index(Func &&func) {
+            size_t current= 0;
+            try {
+                return func(element_tracker{current});
+            } catch(...) {
+                throw indexed_exception(current);
+            }
+        }
+
+        /// The number of elements in each block for the parallel extrema
+        constexpr size_t extrema_block_size= 65536;
+
+        /// Find the index of the first best element of a view with
+        /// random-access iterators, by searching blocks concurrently and
+        /// then comparing the block results in order
+        template <typename Scheduler, typename View, typename Tag>
+        std::optional<size_t> parallel_arg_extreme(
+            Scheduler const &scheduler, View &view, Tag tag, std::true_type) {
+            auto const start= view.begin();
+            auto const finish= view.end();
+            using iterator= typename std::decay<decltype(start)>::type;
+            using contiguous= is_contiguous_arithmetic_iterator<iterator>;
+            size_t const size= static_cast<size_t>(finish - start);
+            size_t const blocks=
+                (size + extrema_block_size - 1) / extrema_block_size;
+            if(blocks < 2)
+                return with_element_index([&](element_tracker tracker) {
+                    return arg_extreme(
+                        start, finish, tag, contiguous(), tracker);
+                });
+
+            size_t const base_index= (*start).index;
+            std::vector<size_t> offsets(blocks);
+            first_exception errors;
+            bulk_execute_and_wait(
+                scheduler, blocks, [&](size_t first, size_t last) noexcept {
+                    size_t current= base_index + first * extrema_block_size;
+                    try {
+                        for(size_t block= first; block != last; ++block) {
+                            size_t const offset= block * extrema_block_size;
+                            size_t const block_end=
+                                size - offset > extrema_block_size ?
+                                    offset + extrema_block_size :
+                                    size;
+                            offsets[block]=
+                                *arg_extreme(
+                                    start + static_cast<ptrdiff_t>(offset),
+                                    start + static_cast<ptrdiff_t>(block_end),
+                                    tag, contiguous(),
+                                    element_tracker{current}) -
+                                base_index;
+                        }
+                    } catch(...) {
+                        errors.record(current);
+                    }
+                });
+            errors.rethrow_if_failed();
+
+            return with_element_index([&](element_tracker tracker) {
+                size_t best= offsets[0];
+                for(size_t block= 1; block != blocks; ++block) {
+                    tracker.reached(base_index + offsets[block]);
+                    if(Tag::better(
+                           (*(start + static_cast<ptrdiff_t>(offsets[block])))
+                               .value,
+                           (*(start + static_cast<ptrdiff_t>(best))).value))
+                        best= offsets[block];
+                }
+                return std::optional<size_t>(base_index + best);
+            });
+        }
+
+        /// Find the index of the first best element of any other view
+        /// sequentially
+        template <typename Scheduler, typename View, typename Tag>
+        std::optional<size_t> parallel_arg_extreme(
+            Scheduler const &, View &view, Tag tag, std::false_type) {
+            auto first= view.begin();
+            auto last= view.end();
+            return with_element_index([&](element_tracker tracker) {
+                return arg_extreme(
+                    first, last, tag,
+                    is_contiguous_arithmetic_iterator<decltype(first)>(),
+                    tracker);
+            });
+        }
+
+        /// Select the top k elements of a view with random-access iterators,
+        /// by selecting the top k of each block concurrently, and then the
+        /// top k of the block results
+        template <typename Scheduler, typename View>
+        std::vector<size_t> parallel_top_k_indices(
+            Scheduler const &scheduler, View &view, size_t k,
+            std::true_type) {
+            auto const start= view.begin();
+            auto const finish= view.end();
+            using iterator= typename std::decay<decltype(start)>::type;
+            using contiguous= is_contiguous_arithmetic_iterator<iterator>;
+            size_t const size= static_cast<size_t>(finish - start);
+            size_t const blocks=
+                (size + extrema_block_size - 1) / extrema_block_size;
+            if((blocks < 2) || !k)
+                return with_element_index([&](element_tracker tracker) {
+                    return ranked_indices(
+                        select_top_k(start, finish, k, contiguous(), tracker));
+                });
+
+            using ranked_vector= decltype(select_top_k(
+                start, finish, k, contiguous(), no_element_tracker()));
+            size_t const base_index= (*start).index;
+            std::vector<ranked_vector> results(blocks);
+            first_exception errors;
+            bulk_execute_and_wait(
+                scheduler, blocks, [&](size_t first, size_t last) noexcept {
+                    size_t current= base_index + first * extrema_block_size;
+                    try {
+                        for(size_t block= first; block != last; ++block) {
+                            size_t const offset= block * extrema_block_size;
+                            size_t const block_end=
+                                size - offset > extrema_block_size ?
+                                    offset + extrema_block_size :
+                                    size;
+                            results[block]= select_top_k(
+                                start + static_cast<ptrdiff_t>(offset),
+                                start + static_cast<ptrdiff_t>(block_end), k,
+                                contiguous(), element_tracker{current});
+                        }
+                    } catch(...) {
+                        errors.record(current);
+                    }
+                });
+            errors.rethrow_if_failed();
+
+            return with_element_index([&](element_tracker tracker) {
+                top_k_selection<
+                    decltype(std::declval<ranked_vector &>().front().value)>
+                    selection(k);
+                for(auto const &result : results) {
+                    for(auto const &entry : result) {
+                        tracker.reached(entry.index);
+                        selection.add(entry.value, entry.index);
+                    }
+                }
+                return ranked_indices(selection.take());
+            });
+        }
+
+        /// Select the top k elements of any other view sequentially
+        template <typename Scheduler, typename View>
+        std::vector<size_t> parallel_top_k_indices(
+            Scheduler const &, View &view, size_t k, std::false_type) {
+            auto first= view.begin();
+            auto last= view.end();
+            return with_element_index([&](element_tracker tracker) {
+                return ranked_indices(select_top_k(
+                    first, last, k,
+                    is_contiguous_arithmetic_iterator<decltype(first)>(),
+                    tracker));
+            });
+        }
+
+        /// The number of elements in each block for the parallel
+        /// indices_where
+        constexpr size_t where_block_size= 65536;
+
+        /// Write the indices of the matching elements of a view with
+        /// random-access iterators to out, in two passes over blocks of the
+        /// view: first the matches in each block are counted concurrently,
+        /// and then, once the position of each block's indices in the output
+        /// is known, the indices are written concurrently
+        template <
+            typename Scheduler, typename View, typename Predicate,
+            typename RandomAccessIterator>
+        RandomAccessIterator parallel_indices_where(
+            Scheduler const &scheduler, View &view, Predicate &pred,
+            RandomAccessIterator out, std::true_type) {
+            auto const start= view.begin();
+            auto const finish= view.end();
+            using iterator= typename std::decay<decltype(start)>::type;
+            using contiguous=
+                can_compact_contiguous_indices<iterator, RandomAccessIterator>;
+            size_t const size= static_cast<size_t>(finish - start);
+            size_t const blocks=
+                (size + where_block_size - 1) / where_block_size;
+            if(blocks < 2)
+                return with_element_index([&](element_tracker tracker) {
+                    return indices_where(
+                        start, finish, pred, out, contiguous(), tracker);
+                });
+
+            size_t const base_index= (*start).index;
+            first_exception errors;
+            auto const for_each_block= [&](auto const &process) {
+                bulk_execute_and_wait(
+                    scheduler, blocks,
+                    [&](size_t first, size_t last) noexcept {
+                        size_t current= base_index + first * where_block_size;
+                        try {
+                            for(size_t block= first; block != last; ++block) {
+                                size_t const offset= block * where_block_size;
+                                size_t const block_end=
+                                    size - offset > where_block_size ?
+                                        offset + where_block_size :
+                                        size;
+                                process(
+                                    block,
+                                    start + static_cast<ptrdiff_t>(offset),
+                                    start + static_cast<ptrdiff_t>(block_end),
+                                    element_tracker{current});
+                            }
+                        } catch(...) {
+                            errors.record(current);
+                        }
+                    });
+                errors.rethrow_if_failed();
+            };
+
+            std::vector<size_t> positions(blocks);
+            for_each_block([&](size_t block, iterator const &first,
+                               iterator const &last, element_tracker tracker) {
+                positions[block]= count_where(first, last, pred, tracker);
+            });
+            size_t total= 0;
+            for(auto &position : positions) {
+                size_t const count= position;
+                position= total;
+                total+= count;
+            }
+            for_each_block([&](size_t block, iterator const &first,
+                               iterator const &last, element_tracker tracker) {
+                indices_where(
+                    first, last, pred,
+                    out + static_cast<ptrdiff_t>(positions[block]),
+                    contiguous(), tracker);
+            });
+            return out + static_cast<ptrdiff_t>(total);
+        }
+
+        /// Write the indices of the matching elements of any other view to
+        /// out sequentially
+        template <
+            typename Scheduler, typename View, typename Predicate,
+            typename RandomAccessIterator>
+        RandomAccessIterator parallel_indices_where(
+            Scheduler const &, View &view, Predicate &pred,
+            RandomAccessIterator out, std::false_type) {
+            auto first= view.begin();
+            auto last= view.end();
+            return with_element_index([&](element_tracker tracker) {
+                return indices_where(
+                    first, last, pred, out,
+                    can_compact_contiguous_indices<
+                        decltype(first), RandomAccessIterator>(),
+                    tracker);
+            });
+        }
+
+        /// Find the first matching element of any other view sequentially
+        template <typename Scheduler, typename View, typename Predicate>
+        std::optional<size_t> find_first_index_impl(
+            Scheduler const &, View &view, Predicate &pred, std::false_type) {
+            size_t index= 0;
+            try {
+                for(auto &&entry : view) {
+                    index= entry.index;
+                    if(pred(entry))
+                        return index;
+                }
+            } catch(...) {
+                throw indexed_exception(index);
+            }
+            return std::nullopt;
+        }
+    }
+
+    /// Create a sender that processes an indexed view as a single bulk
+    /// operation. When the operation is started, the scheduler splits views
+    /// with random-access iterators into chunks and processes them
+    /// concurrently; other views are processed sequentially as a single
+    /// chunk. func is called with each element of the view, which holds the
+    /// index of that element in the view. If func throws, the remaining
+    /// elements are skipped, and the operation completes with an
+    /// indexed_exception that holds the index of the element and nests the
+    /// exception.
+    template <typename Scheduler, typename View, typename Func>
+    detail::bulk_indexed_sender<
+        Scheduler, typename std::decay<View>::type, Func>
+    bulk_indexed(Scheduler scheduler, View &&view, Func func) {
+        return detail::bulk_indexed_sender<
+            Scheduler, typename std::decay<View>::type, Func>(
+            std::move(scheduler), std::forward<View>(view), std::move(func),
+            nullptr);
+    }
+
+    /// Create a sender as for bulk_indexed(scheduler,view,func), which stops
+    /// processing elements when token is cancelled. The token is checked
+    /// before each block of elements, and if any are skipped, the operation
+    /// completes with operation_cancelled. An exception from func also
+    /// cancels the token. The token must remain valid until the operation
+    /// completes.
+    template <typename Scheduler, typename View, typename Func>
+    detail::bulk_indexed_sender<
+        Scheduler, typename std::decay<View>::type, Func>
+    bulk_indexed(
+        Scheduler scheduler, View &&view, Func func,
+        cancellation_token &token) {
+        return detail::bulk_indexed_sender<
+            Scheduler, typename std::decay<View>::type, Func>(
+            std::move(scheduler), std::forward<View>(view), std::move(func),
+            &token);
+    }
+
+    /// Create a sender that processes the elements of an unordered container
+    /// concurrently, by splitting it into groups of buckets. When the
+    /// operation is started, the elements in each group are counted
+    /// concurrently to give each group a base index, and then func is called
+    /// with each element and its index, which are dense in the range
+    /// [0,container.size()). The indices follow bucket order, which need not
+    /// be the same as the iteration order of the container. The container
+    /// must not be modified until the operation completes. Exceptions are
+    /// reported as for bulk_indexed.
+    template <typename Scheduler, typename Container, typename Func>
+    detail::bulk_indexed_buckets_sender<Scheduler, Container, Func>
+    bulk_indexed_buckets(
+        Scheduler scheduler, Container &container, Func func) {
+        return detail::bulk_indexed_buckets_sender<Scheduler, Container, Func>(
+            std::move(scheduler), container, std::move(func), nullptr);
+    }
+
+    /// Create a sender as for bulk_indexed_buckets(scheduler,container,func),
+    /// which stops processing elements when token is cancelled. The token
+    /// is checked before each group of buckets.
+    template <typename Scheduler, typename Container, typename Func>
+    detail::bulk_indexed_buckets_sender<Scheduler, Container, Func>
+    bulk_indexed_buckets(
+        Scheduler scheduler, Container &container, Func func,
+        cancellation_token &token) {
+        return detail::bulk_indexed_buckets_sender<Scheduler, Container, Func>(
+            std::move(scheduler), container, std::move(func), &token);
+    }
+
+    /// Find the index of the first element of the view for which pred
+    /// returns true, or std::nullopt if there is none. Views with
+    /// random-access iterators are split into chunks that are searched
+    /// concurrently on the scheduler. The lowest index found so far is held
+    /// in a shared atomic, and chunks stop searching once it is below the
+    /// next block of elements, so a match near the start of the view ends
+    /// the search early. Other views are searched sequentially. If pred
+    /// throws, the exception is rethrown wrapped in an indexed_exception.
+    /// Must not be called from a thread that is needed to run the chunks.
+    template <typename Scheduler, typename View, typename Predicate>
+    std::optional<size_t>
+    find_first_index(Scheduler scheduler, View &&view, Predicate pred) {
+        return detail::find_first_index_impl(
+            scheduler, view, pred,
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Compute an inclusive scan of the values of a view with random-access
+    /// iterators. For each element x_i of the view, out[i] is assigned an
+    /// indexed_scan_result holding x_i.index and
+    /// op(...op(op(init,x_0.value),x_1.value)...,x_i.value). op must be
+    /// associative, as the elements are combined in blocks. The scan runs
+    /// in two passes on the scheduler: the totals of the blocks are computed
+    /// concurrently, and then the results for each block are written
+    /// concurrently. out must be a random-access iterator to the start of
+    /// an output range that already holds at least as many elements as the
+    /// view, as the blocks write to their own parts of it; an inserting
+    /// iterator cannot be used. Returns an iterator past the last output.
+    /// If op throws, the exception is rethrown wrapped in an
+    /// indexed_exception. Must not be called from a thread that is needed
+    /// to run the chunks.
+    template <
+        typename Scheduler, typename View, typename RandomAccessIterator,
+        typename T, typename BinaryOp= std::plus<>>
+    RandomAccessIterator indexed_inclusive_scan(
+        Scheduler scheduler, View &&view, RandomAccessIterator out, T init,
+        BinaryOp op= BinaryOp()) {
+        return detail::indexed_scan(
+            scheduler, view, std::move(out), std::move(init), op,
+            detail::inclusive_scan_tag());
+    }
+
+    /// Compute an exclusive scan of the values of a view with random-access
+    /// iterators, as for indexed_inclusive_scan, except that the value of
+    /// out[i] is the combination of init with the elements before x_i, so
+    /// the value of out[0] is init.
+    template <
+        typename Scheduler, typename View, typename RandomAccessIterator,
+        typename T, typename BinaryOp= std::plus<>>
+    RandomAccessIterator indexed_exclusive_scan(
+        Scheduler scheduler, View &&view, RandomAccessIterator out, T init,
+        BinaryOp op= BinaryOp()) {
+        return detail::indexed_scan(
+            scheduler, view, std::move(out), std::move(init), op,
+            detail::exclusive_scan_tag());
+    }
+
+    /// Combine the values of the elements of a view with op, and return the
+    /// combination of init with the result. For views with random-access
+    /// iterators, blocks of 4096 elements are reduced concurrently on the
+    /// scheduler, and the block results are combined in a fixed binary
+    /// tree, with adjacent blocks combined in index order. The tree depends
+    /// only on the size of the view, so the result is the same for any
+    /// number of threads, even for floating-point values. op must be
+    /// associative, and must accept two values of type T, but need not be
+    /// commutative. Other views are reduced sequentially. If op throws, the
+    /// exception is rethrown wrapped in an indexed_exception. Must not be
+    /// called from a thread that is needed to run the chunks.
+    template <
+        typename Scheduler, typename View, typename T,
+        typename BinaryOp= std::plus<>>
+    T indexed_reduce(
+        Scheduler scheduler, View &&view, T init, BinaryOp op= BinaryOp()) {
+        return detail::indexed_reduce_impl(
+            scheduler, view, std::move(init), op,
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Find the index of the first smallest value in the view, as for
+    /// argmin(view). Views with random-access iterators are split into
+    /// blocks that are searched concurrently on the scheduler. If a
+    /// comparison throws, the exception is rethrown wrapped in an
+    /// indexed_exception that holds the index of the element being
+    /// compared. Must not be called from a thread that is needed to run the
+    /// chunks.
+    template <typename Scheduler, typename View>
+    std::optional<size_t> argmin(Scheduler scheduler, View &&view) {
+        return detail::parallel_arg_extreme(
+            scheduler, view, detail::min_tag(),
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Find the index of the first largest value in the view, as for
+    /// argmax(view), with exceptions handled as for argmin. Views with
+    /// random-access iterators are split into blocks that are searched
+    /// concurrently on the scheduler. Must not be called from a thread that
+    /// is needed to run the chunks.
+    template <typename Scheduler, typename View>
+    std::optional<size_t> argmax(Scheduler scheduler, View &&view) {
+        return detail::parallel_arg_extreme(
+            scheduler, view, detail::max_tag(),
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Find the indices of the k largest values in the view, as for
+    /// top_k_indices(view,k). Views with random-access iterators are split
+    /// into blocks, the top k of each block are selected concurrently on
+    /// the scheduler, and then the top k of those are selected. Exceptions
+    /// are handled as for argmin. Must not be called from a thread that is
+    /// needed to run the chunks.
+    template <typename Scheduler, typename View>
+    std::vector<size_t>
+    top_k_indices(Scheduler scheduler, View &&view, size_t k) {
+        return detail::parallel_top_k_indices(
+            scheduler, view, k,
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Write the index of each element x of the view for which pred(x) is
+    /// true to out, in order, as for indices_where(view,pred,out), and
+    /// return the end of the written indices. Views with random-access
+    /// iterators are processed in two passes over blocks of the view: the
+    /// matches in each block are counted concurrently on the scheduler, and
+    /// then each block writes its indices to its own part of the output
+    /// concurrently. pred is therefore called twice for each element, and
+    /// must give the same result each time. The output must have room for
+    /// all the matching indices. If pred throws, the exception is rethrown
+    /// wrapped in an indexed_exception that holds the index of the element.
+    /// Must not be called from a thread that is needed to run the chunks.
+    template <
+        typename Scheduler, typename View, typename Predicate,
+        typename RandomAccessIterator>
+    RandomAccessIterator indices_where(
+        Scheduler scheduler, View &&view, Predicate pred,
+        RandomAccessIterator out) {
+        return detail::parallel_indices_where(
+            scheduler, view, pred, std::move(out),
+            detail::has_random_access_iterators<
+                typename std::remove_reference<View>::type>());
+    }
+
+    /// Start the operation for the sender and wait for it to complete. If it
+    /// completes with an exception, rethrow it. Must not be called from a
+    /// thread that is needed to complete the operation.
+    template <typename Sender> void sync_wait(Sender &&sender) {
+        detail::sync_wait_state state;
+        auto operation= std::forward<Sender>(sender).connect(
+            detail::sync_wait_receiver(state));
+        operation.start();
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.cond.wait(lock, [&] { return state.done; });
+        if(state.error)
+            std::rethrow_exception(state.error);
+    }
+}
+
+#endif
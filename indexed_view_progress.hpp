@@ -0,0 +1,328 @@
+#ifndef JSS_INDEXED_VIEW_PROGRESS_HPP
+#define JSS_INDEXED_VIEW_PROGRESS_HPP
+#include "indexed_view.hpp"
+#include <atomic>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+
+namespace jss {
+    namespace detail {
+        /// The size of a cache line, used to keep progress counters away
+        /// from other data
+        constexpr size_t cache_line_size= 64;
+    }
+
+    /// The progress of a loop over an observed_indexed_view, which can be
+    /// read from another thread. The counter occupies a whole cache line, so
+    /// publishing it does not contend with writes to neighbouring data.
+    class alignas(detail::cache_line_size) indexed_progress {
+    public:
+        /// Construct a counter with a published index of zero
+        indexed_progress() noexcept : index(0) {}
+
+        indexed_progress(indexed_progress const &)= delete;
+        indexed_progress &operator=(indexed_progress const &)= delete;
+
+        /// The most recently published index
+        size_t load() const noexcept {
+            return index.load(std::memory_order_relaxed);
+        }
+
+        /// Publish a new index
+        void publish(size_t new_index) noexcept {
+            index.store(new_index, std::memory_order_relaxed);
+        }
+
+    private:
+        /// The published index
+        std::atomic<size_t> index;
+    };
+
+    static_assert(
+        sizeof(indexed_progress) == detail::cache_line_size,
+        "Progress counters must fill a cache line");
+
+    /// The default number of iterations between updates to the progress of
+    /// an observed_indexed_view
+    constexpr size_t default_progress_interval= 1024;
+
+    namespace detail {
+        /// A view that wraps an indexed view, and publishes the index of the
+        /// element reached every Interval elements, and when the loop
+        /// reaches the end
+        template <typename View, size_t Interval>
+        class observed_indexed_view_type {
+            static_assert(Interval != 0, "Interval must not be zero");
+
+            /// The iterator type of the wrapped view
+            using underlying_iterator=
+                decltype(std::declval<View &>().begin());
+
+            /// Is the wrapped iterator a forward iterator?
+            static constexpr bool forward=
+                is_forward_iterator<underlying_iterator>::value;
+
+        public:
+            /// The value_type of our range is the value_type of the wrapped
+            /// view
+            using value_type= typename underlying_iterator::value_type;
+
+            /// Construct a view that wraps view_ and updates progress_
+            observed_indexed_view_type(
+                View &&view_, indexed_progress &progress_) :
+                view(std::move(view_)),
+                progress(&progress_) {}
+
+            /// Splitting constructor, if the wrapped view can be split. Both
+            /// parts update the same progress counter
+            template <
+                typename Split,
+                typename= typename std::enable_if<
+                    is_split_tag<Split>::value &&
+                    std::is_constructible<View, View &, Split const &>::value>::
+                    type>
+            observed_indexed_view_type(
+                observed_indexed_view_type &other, Split const &split_) :
+                view(other.view, split_),
+                progress(other.progress) {}
+
+            /// The view can be split in proportion if the wrapped view can
+            static constexpr bool is_splittable_in_proportion=
+                std::is_constructible<
+                    View, View &, proportional_split const &>::value;
+
+            /// The iterator for our range
+            class iterator {
+            public:
+                /// Required iterator typedefs
+                using value_type= typename underlying_iterator::value_type;
+                /// Required iterator typedefs
+                using reference= typename underlying_iterator::reference;
+                /// Required iterator typedefs: the same as the wrapped
+                /// iterator, if that is a forward iterator or better, so
+                /// random-access views remain random-access
+                using iterator_category= typename std::conditional<
+                    forward,
+                    typename std::iterator_traits<
+                        underlying_iterator>::iterator_category,
+                    std::input_iterator_tag>::type;
+                /// Required iterator typedefs
+                using pointer= typename underlying_iterator::pointer;
+                /// Required iterator typedefs: cannot do std::distance on input
+                /// iterators
+                using difference_type= typename std::conditional<
+                    forward,
+                    typename std::iterator_traits<
+                        underlying_iterator>::difference_type,
+                    void>::type;
+
+                /// Default constructor, as required for forward iterators
+                iterator()= default;
+
+                /// Compare iterators
+                friend bool
+                operator==(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter == rhs.source_iter;
+                }
+                /// Compare iterators
+                friend bool
+                operator!=(iterator const &lhs, iterator const &rhs) {
+                    return !(lhs == rhs);
+                }
+
+                /// Dereference the iterator
+                decltype(auto) operator*() const {
+                    return *source_iter;
+                }
+
+                /// Dereference for iter->m
+                decltype(auto) operator->() const {
+                    return source_iter.operator->();
+                }
+
+                /// Pre-increment. When the index of the element reached is a
+                /// multiple of Interval, or the iterator has reached the end,
+                /// publish it
+                iterator &operator++() {
+                    ++source_iter;
+                    reached();
+                    return *this;
+                }
+
+                /// Post-increment
+                decltype(auto) operator++(int) {
+                    auto temp= source_iter++;
+                    reached();
+                    return temp;
+                }
+
+                /// The remaining operations are only valid if the wrapped
+                /// iterator is a random-access iterator. They move the
+                /// iterator without publishing progress
+
+                /// Pre-decrement
+                iterator &operator--() {
+                    --source_iter;
+                    return *this;
+                }
+
+                /// Post-decrement
+                iterator operator--(int) {
+                    iterator temp(*this);
+                    --source_iter;
+                    return temp;
+                }
+
+                /// Advance the iterator by the specified amount
+                iterator &operator+=(ptrdiff_t offset) {
+                    source_iter+= offset;
+                    return *this;
+                }
+
+                /// Move the iterator back by the specified amount
+                iterator &operator-=(ptrdiff_t offset) {
+                    source_iter-= offset;
+                    return *this;
+                }
+
+                /// Get an iterator advanced by the specified amount
+                friend iterator operator+(iterator iter, ptrdiff_t offset) {
+                    iter+= offset;
+                    return iter;
+                }
+
+                /// Get an iterator advanced by the specified amount
+                friend iterator operator+(ptrdiff_t offset, iterator iter) {
+                    iter+= offset;
+                    return iter;
+                }
+
+                /// Get an iterator moved back by the specified amount
+                friend iterator operator-(iterator iter, ptrdiff_t offset) {
+                    iter-= offset;
+                    return iter;
+                }
+
+                /// The distance between two iterators
+                friend ptrdiff_t
+                operator-(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter - rhs.source_iter;
+                }
+
+                /// Dereference the iterator at the specified offset
+                decltype(auto) operator[](ptrdiff_t offset) const {
+                    return source_iter[offset];
+                }
+
+                /// Ordering of iterators
+                friend bool
+                operator<(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter < rhs.source_iter;
+                }
+
+                /// Ordering of iterators
+                friend bool
+                operator>(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter > rhs.source_iter;
+                }
+
+                /// Ordering of iterators
+                friend bool
+                operator<=(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter <= rhs.source_iter;
+                }
+
+                /// Ordering of iterators
+                friend bool
+                operator>=(iterator const &lhs, iterator const &rhs) {
+                    return lhs.source_iter >= rhs.source_iter;
+                }
+
+            private:
+                friend class observed_indexed_view_type;
+
+                /// Construct an iterator that wraps source_iter_, for a
+                /// range that ends at source_end_
+                iterator(
+                    underlying_iterator &&source_iter_,
+                    underlying_iterator &&source_end_,
+                    indexed_progress *progress_) :
+                    source_iter(std::move(source_iter_)),
+                    source_end(std::move(source_end_)), progress(progress_) {}
+
+                /// The index of the element the wrapped iterator refers to.
+                /// This is the number of elements passed, so is also valid
+                /// once it has been incremented to the end
+                size_t index() const noexcept {
+                    return source_iter.checkpoint().index;
+                }
+
+                /// Publish the index of the element reached if it is a
+                /// multiple of Interval, which is a single test of the low
+                /// bits when Interval is a power of two. When the iterator
+                /// reaches the end, publish the number of elements, so the
+                /// final progress is exact. The test for the end is the same
+                /// as the loop condition, so the compiler merges the two
+                void reached() {
+                    size_t const current= index();
+                    if(!(current % Interval) || (source_iter == source_end))
+                        progress->publish(current);
+                }
+
+                /// The iterator for the wrapped view
+                underlying_iterator source_iter;
+                /// The end iterator for the wrapped view
+                underlying_iterator source_end;
+                /// The progress counter to update
+                indexed_progress *progress= nullptr;
+            };
+
+            /// Get an iterator for the start of the range
+            iterator begin() {
+                return iterator(view.begin(), view.end(), progress);
+            }
+
+            /// Get an iterator for the end of the range
+            iterator end() {
+                return iterator(view.end(), view.end(), progress);
+            }
+
+        private:
+            /// The wrapped view
+            View view;
+            /// The progress counter to update
+            indexed_progress *progress;
+        };
+    }
+
+    /// Create an indexed view over source, as for indexed_view, that
+    /// publishes the index of the element reached to progress every
+    /// Interval elements, so another thread can monitor how far a long loop
+    /// has got. While the loop runs, the published index is a multiple of
+    /// Interval, so it may lag the loop by up to Interval-1 elements; when
+    /// the loop reaches end(), the number of elements is published. If
+    /// Interval is zero, or JSS_INDEXED_VIEW_DISABLE_PROGRESS is defined,
+    /// progress is not published, and this returns indexed_view(source)
+    /// itself, so the loop is exactly the same as one over a plain view.
+    template <size_t Interval= default_progress_interval, typename Range>
+    auto observed_indexed_view(Range &&source, indexed_progress &progress) {
+#ifdef JSS_INDEXED_VIEW_DISABLE_PROGRESS
+        (void)progress;
+        return indexed_view(std::forward<Range>(source));
+#else
+        if constexpr(Interval == 0) {
+            (void)progress;
+            return indexed_view(std::forward<Range>(source));
+        } else {
+            using view_type=
+                decltype(indexed_view(std::forward<Range>(source)));
+            return detail::observed_indexed_view_type<view_type, Interval>(
+                indexed_view(std::forward<Range>(source)), progress);
+        }
+#endif
+    }
+}
+
+#endif
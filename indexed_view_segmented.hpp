@@ -0,0 +1,155 @@
+#ifndef JSS_INDEXED_VIEW_SEGMENTED_HPP
+#define JSS_INDEXED_VIEW_SEGMENTED_HPP
+#include "indexed_view.hpp"
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+
+namespace jss {
+    /// Traits for iterators over block-based containers, where the elements
+    /// are stored in contiguous segments. The primary template is for
+    /// iterators that are not segmented. Specializations for segmented
+    /// iterators set is_segmented to true, and provide a static
+    /// segment_size(it) function that returns the number of elements from
+    /// the dereferenceable iterator it to the end of its segment, which can
+    /// be accessed through a pointer to *it.
+    template <typename Iterator> struct segmented_iterator_traits {
+        /// The iterator is not segmented
+        static constexpr bool is_segmented= false;
+    };
+
+#ifdef __GLIBCXX__
+    /// std::deque iterators in libstdc++ are segmented: each iterator holds
+    /// a pointer to the end of its block
+    template <typename T, typename Ref, typename Ptr>
+    struct segmented_iterator_traits<std::_Deque_iterator<T, Ref, Ptr>> {
+        /// The iterator is segmented
+        static constexpr bool is_segmented= true;
+
+        /// The number of elements from it to the end of its block
+        static size_t
+        segment_size(std::_Deque_iterator<T, Ref, Ptr> const &it) noexcept {
+            return static_cast<size_t>(it._M_last - it._M_cur);
+        }
+    };
+#endif
+
+    namespace detail {
+        /// Is the iterator for a view a counted_indexed_iterator over a
+        /// segmented iterator?
+        template <typename Iterator>
+        struct is_segmented_indexed_iterator : std::false_type {};
+
+        /// Is the iterator for a view a counted_indexed_iterator over a
+        /// segmented iterator?
+        template <typename UnderlyingIterator>
+        struct is_segmented_indexed_iterator<
+            counted_indexed_iterator<UnderlyingIterator>>
+            : std::integral_constant<
+                  bool, segmented_iterator_traits<
+                            UnderlyingIterator>::is_segmented> {};
+
+        /// Tag for iterating over the elements one at a time
+        struct element_iteration_tag {};
+        /// Tag for iterating over segmented counted iterators a segment at a
+        /// time
+        struct segment_iteration_tag {};
+
+        /// The tag used to select the implementation of indexed_for_each for
+        /// a view with the specified iterator type. Other headers specialize
+        /// this for their own iterators, and provide a matching overload of
+        /// indexed_for_each_impl, which is found by argument-dependent lookup
+        template <typename Iterator> struct indexed_for_each_tag {
+            /// The tag type
+            using type= typename std::conditional<
+                is_segmented_indexed_iterator<Iterator>::value,
+                segment_iteration_tag, element_iteration_tag>::type;
+        };
+
+        /// Call func(index,element) for each element in [first,last), one
+        /// segment at a time. The inner loop is over a contiguous segment,
+        /// so it can be vectorized
+        template <typename Iterator, typename Func>
+        void for_each_segment_element(
+            Iterator const &first, Iterator const &last, Func func) {
+            using underlying_iterator=
+                typename std::decay<decltype(counted_iterator_access::source(
+                    first))>::type;
+            using traits= segmented_iterator_traits<underlying_iterator>;
+            size_t index= counted_iterator_access::index(first);
+            size_t const end_index= counted_iterator_access::index(last);
+            underlying_iterator source= counted_iterator_access::source(first);
+            while(index != end_index) {
+                size_t const remaining= end_index - index;
+                size_t segment= traits::segment_size(source);
+                if(segment > remaining)
+                    segment= remaining;
+                auto const segment_begin= std::addressof(*source);
+                for(size_t i= 0; i < segment; ++i) {
+                    func(index + i, segment_begin[i]);
+                }
+                index+= segment;
+                if(index != end_index)
+                    source+= static_cast<ptrdiff_t>(segment);
+            }
+        }
+
+        /// Call func for each element of a segmented range, a segment at a
+        /// time
+        template <typename Iterator, typename Func>
+        void indexed_for_each_impl(
+            Iterator const &first, Iterator const &last, Func &func,
+            segment_iteration_tag) {
+            using value_type= typename Iterator::value_type;
+            for_each_segment_element(
+                first, last, [&](size_t index, auto &element) {
+                    func(value_type{index, element});
+                });
+        }
+
+        /// Call func for each element of any other range
+        template <typename Iterator, typename Func>
+        void indexed_for_each_impl(
+            Iterator first, Iterator const &last, Func &func,
+            element_iteration_tag) {
+            for(; first != last; ++first) {
+                func(*first);
+            }
+        }
+    }
+
+    /// Call func(x) for each element x of the view, where x.index is the
+    /// index and x.value is the element, as for a range-based for loop over
+    /// the view. If the view is over a random-access range with segmented
+    /// iterators, such as std::deque, the elements are processed a segment
+    /// at a time, so the block boundary checks are only done once per
+    /// segment, and the inner loop can be vectorized.
+    template <typename View, typename Func>
+    Func indexed_for_each(View &&view, Func func) {
+        auto first= view.begin();
+        auto last= view.end();
+        indexed_for_each_impl(
+            first, last, func,
+            typename detail::indexed_for_each_tag<decltype(first)>::type());
+        return func;
+    }
+
+    /// Combine the elements of the view in order with init, so the result
+    /// is op(...op(op(init,x0),x1)...,xn), where each xi has an index and
+    /// value as for a range-based for loop over the view. Segmented ranges
+    /// are processed a segment at a time, as for indexed_for_each.
+    template <typename View, typename T, typename BinaryOp>
+    T indexed_accumulate(View &&view, T init, BinaryOp op) {
+        auto first= view.begin();
+        auto last= view.end();
+        auto combine= [&](auto &&x) { init= op(std::move(init), std::move(x)); };
+        indexed_for_each_impl(
+            first, last, combine,
+            typename detail::indexed_for_each_tag<decltype(first)>::type());
+        return init;
+    }
+}
+
+#endif
@@ -0,0 +1,544 @@
+#ifndef JSS_INDEXED_VIEW_TEXT_HPP
+#define JSS_INDEXED_VIEW_TEXT_HPP
+#include "indexed_view.hpp"
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include <stddef.h>
+#include <string.h>
+
+namespace jss {
+    namespace detail {
+        /// The replacement character, returned for invalid UTF-8
+        constexpr char32_t utf8_replacement_character= 0xfffd;
+
+        /// Is the byte a UTF-8 continuation byte?
+        inline bool is_utf8_continuation(unsigned char byte) noexcept {
+            return (byte & 0xc0) == 0x80;
+        }
+
+        /// Decode the UTF-8 sequence starting at pos, which must be before
+        /// end, and set length to the number of bytes it occupies. Invalid,
+        /// overlong and truncated sequences, and encoded surrogates, decode
+        /// as the replacement character with a length of one byte, so every
+        /// byte is part of exactly one code point.
+        inline char32_t decode_utf8(
+            unsigned char const *pos, unsigned char const *end,
+            size_t &length) noexcept {
+            unsigned char const lead= pos[0];
+            length= 1;
+            if(lead < 0x80)
+                return lead;
+            size_t needed;
+            char32_t value;
+            unsigned char min_second= 0x80;
+            unsigned char max_second= 0xbf;
+            if((lead >= 0xc2) && (lead <= 0xdf)) {
+                needed= 2;
+                value= lead & 0x1f;
+            } else if((lead >= 0xe0) && (lead <= 0xef)) {
+                needed= 3;
+                value= lead & 0x0f;
+                if(lead == 0xe0)
+                    min_second= 0xa0;
+                else if(lead == 0xed)
+                    max_second= 0x9f;
+            } else if((lead >= 0xf0) && (lead <= 0xf4)) {
+                needed= 4;
+                value= lead & 0x07;
+                if(lead == 0xf0)
+                    min_second= 0x90;
+                else if(lead == 0xf4)
+                    max_second= 0x8f;
+            } else {
+                return utf8_replacement_character;
+            }
+            if(static_cast<size_t>(end - pos) < needed)
+                return utf8_replacement_character;
+            if((pos[1] < min_second) || (pos[1] > max_second))
+                return utf8_replacement_character;
+            for(size_t i= 1; i < needed; ++i) {
+                if(!is_utf8_continuation(pos[i]))
+                    return utf8_replacement_character;
+                value= (value << 6) | (pos[i] & 0x3f);
+            }
+            length= needed;
+            return value;
+        }
+
+        /// Find the first byte in [pos,end) that is not ASCII, or end
+        inline unsigned char const *find_non_ascii(
+            unsigned char const *pos, unsigned char const *end) noexcept {
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            while(end - pos >= 16) {
+                int const mask= _mm_movemask_epi8(
+                    _mm_loadu_si128(reinterpret_cast<__m128i const *>(pos)));
+                if(mask) {
+                    unsigned offset= 0;
+                    while(!(mask & (1 << offset)))
+                        ++offset;
+                    return pos + offset;
+                }
+                pos+= 16;
+            }
+#endif
+            while((pos != end) && (*pos < 0x80))
+                ++pos;
+            return pos;
+        }
+
+        /// Advance pos by up to count code points, stopping at end, and
+        /// return the number of code points skipped. Runs of ASCII are
+        /// skipped without decoding.
+        inline size_t skip_utf8(
+            unsigned char const *&pos, unsigned char const *end,
+            size_t count) noexcept {
+            size_t skipped= 0;
+            while((skipped != count) && (pos != end)) {
+                size_t const wanted= count - skipped;
+                size_t const available= static_cast<size_t>(end - pos);
+                unsigned char const *const limit=
+                    pos + (wanted < available ? wanted : available);
+                unsigned char const *const ascii_end=
+                    find_non_ascii(pos, limit);
+                skipped+= static_cast<size_t>(ascii_end - pos);
+                pos= ascii_end;
+                if((skipped != count) && (pos != end)) {
+                    size_t length;
+                    decode_utf8(pos, end, length);
+                    pos+= length;
+                    ++skipped;
+                }
+            }
+            return skipped;
+        }
+    }
+
+    /// A sparse index into UTF-8 text, recording the byte offset of every
+    /// stride-th code point, so a view can seek to any code point by
+    /// decoding at most stride code points
+    class utf8_seek_index {
+    public:
+        /// The default number of code points between entries
+        static constexpr size_t default_stride= 256;
+
+        /// Build the index by scanning the text
+        explicit utf8_seek_index(
+            std::string_view text, size_t stride_= default_stride) :
+            stride(stride_ ? stride_ : 1),
+            count(0) {
+            auto const begin=
+                reinterpret_cast<unsigned char const *>(text.data());
+            auto const end= begin + text.size();
+            unsigned char const *pos= begin;
+            while(pos != end) {
+                offsets.push_back(static_cast<size_t>(pos - begin));
+                count+= detail::skip_utf8(pos, end, stride);
+            }
+        }
+
+        /// The number of code points in the text
+        size_t size() const noexcept {
+            return count;
+        }
+
+        /// The number of code points between entries
+        size_t get_stride() const noexcept {
+            return stride;
+        }
+
+    private:
+        friend class utf8_indexed_view;
+
+        /// The number of code points between entries
+        size_t stride;
+        /// The number of code points in the text
+        size_t count;
+        /// The byte offsets of every stride-th code point
+        std::vector<size_t> offsets;
+    };
+
+    /// A view that decodes UTF-8 text, yielding the index of each code
+    /// point, its byte offset in the text, and its value. Runs of ASCII are
+    /// found with SIMD where available, and are not decoded. Invalid bytes
+    /// yield the replacement character U+FFFD. The view refers to the text,
+    /// and to the seek index if one is supplied, which must remain valid
+    /// while the view is used.
+    class utf8_indexed_view {
+    public:
+        /// The value_type of our range is the index of the code point, its
+        /// byte offset and its value
+        struct value_type {
+            size_t index;
+            size_t byte_offset;
+            char32_t value;
+        };
+
+        /// Construct a view over the text. Without a seek index, seek(k)
+        /// decodes k code points
+        explicit utf8_indexed_view(std::string_view text_) noexcept :
+            text(text_), seek_index(nullptr) {}
+
+        /// Construct a view over the text, with a seek index built from the
+        /// same text
+        utf8_indexed_view(
+            std::string_view text_, utf8_seek_index const &seek_index_) noexcept
+            :
+            text(text_),
+            seek_index(&seek_index_) {}
+
+        /// The iterator for our range
+        class iterator {
+            /// Proxy for ->
+            using arrow_proxy=
+                detail::arrow_proxy<utf8_indexed_view::value_type>;
+            /// Proxy for handling *x++
+            using postinc_return=
+                detail::postinc_return<utf8_indexed_view::value_type>;
+
+        public:
+            /// Required iterator typedefs
+            using value_type= utf8_indexed_view::value_type;
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs
+            using iterator_category= std::input_iterator_tag;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= void;
+
+            /// Compare iterators. Iterators are equal if they refer to the
+            /// same position in the text
+            friend bool
+            operator==(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.pos == rhs.pos;
+            }
+            /// Compare iterators
+            friend bool
+            operator!=(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.pos != rhs.pos;
+            }
+
+            /// Dereference the iterator
+            value_type operator*() const noexcept {
+                return value_type{
+                    index, static_cast<size_t>(pos - begin), current};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const noexcept {
+                return arrow_proxy{**this};
+            }
+
+            /// Get a checkpoint for resuming iteration at this code point,
+            /// holding its index and byte offset
+            indexed_checkpoint checkpoint() const noexcept {
+                return indexed_checkpoint{
+                    index, static_cast<unsigned long long>(pos - begin)};
+            }
+
+            /// Pre-increment
+            iterator &operator++() noexcept {
+                pos= next;
+                ++index;
+                decode();
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) noexcept {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+        private:
+            friend class utf8_indexed_view;
+
+            /// Construct an iterator for the code point with the specified
+            /// index, which starts at pos_
+            iterator(
+                unsigned char const *begin_, unsigned char const *pos_,
+                unsigned char const *end_, size_t index_) noexcept :
+                begin(begin_),
+                pos(pos_), end(end_), next(pos_), ascii_end(pos_),
+                index(index_), current(0) {
+                decode();
+            }
+
+            /// Decode the code point at pos. Inside a known run of ASCII this
+            /// is just a load
+            void decode() noexcept {
+                if(pos == end)
+                    return;
+                if(pos >= ascii_end)
+                    ascii_end= detail::find_non_ascii(pos, end);
+                if(pos < ascii_end) {
+                    current= *pos;
+                    next= pos + 1;
+                } else {
+                    size_t length;
+                    current= detail::decode_utf8(pos, end, length);
+                    next= pos + length;
+                }
+            }
+
+            /// The start of the text
+            unsigned char const *begin;
+            /// The current code point
+            unsigned char const *pos;
+            /// The end of the text
+            unsigned char const *end;
+            /// The next code point
+            unsigned char const *next;
+            /// The end of the known run of ASCII
+            unsigned char const *ascii_end;
+            /// The index of the current code point
+            size_t index;
+            /// The value of the current code point
+            char32_t current;
+        };
+
+        /// Get an iterator for the first code point
+        iterator begin() const noexcept {
+            return iterator(text_begin(), text_begin(), text_end(), 0);
+        }
+
+        /// Get an iterator for the end of the text
+        iterator end() const noexcept {
+            return iterator(text_begin(), text_end(), text_end(), 0);
+        }
+
+        /// Get an iterator for the code point with the specified index, or
+        /// end() if there is no such code point. With a seek index this
+        /// decodes at most stride code points; without one it skips target
+        /// code points from the start.
+        iterator seek(size_t target) const noexcept {
+            unsigned char const *pos= text_begin();
+            size_t start_index= 0;
+            if(seek_index) {
+                if(target >= seek_index->count)
+                    return end();
+                size_t const entry= target / seek_index->stride;
+                start_index= entry * seek_index->stride;
+                pos+= seek_index->offsets[entry];
+            }
+            size_t const skipped=
+                detail::skip_utf8(pos, text_end(), target - start_index);
+            return iterator(
+                text_begin(), pos, text_end(), start_index + skipped);
+        }
+
+        /// Get an iterator for the code point at the byte offset stored in
+        /// the checkpoint, with the index stored in the checkpoint. This
+        /// takes constant time. The checkpoint must come from a view over
+        /// the same text; offsets past the end give end()
+        iterator resume(indexed_checkpoint const &checkpoint) const noexcept {
+            if(checkpoint.offset >= text.size())
+                return end();
+            return iterator(
+                text_begin(),
+                text_begin() + static_cast<size_t>(checkpoint.offset),
+                text_end(), checkpoint.index);
+        }
+
+        /// The number of code points. This is stored in the seek index if
+        /// there is one, and otherwise requires a scan of the text
+        size_t size() const noexcept {
+            if(seek_index)
+                return seek_index->count;
+            unsigned char const *pos= text_begin();
+            return detail::skip_utf8(pos, text_end(), static_cast<size_t>(-1));
+        }
+
+        /// Is the text empty?
+        bool empty() const noexcept {
+            return text.empty();
+        }
+
+    private:
+        /// The start of the text
+        unsigned char const *text_begin() const noexcept {
+            return reinterpret_cast<unsigned char const *>(text.data());
+        }
+        /// The end of the text
+        unsigned char const *text_end() const noexcept {
+            return text_begin() + text.size();
+        }
+
+        /// The text
+        std::string_view text;
+        /// The seek index, if any
+        utf8_seek_index const *seek_index;
+    };
+
+    /// A view that splits a buffer into lines, yielding the index of each
+    /// line and a string_view of its contents, without the line terminator.
+    /// Lines are terminated by \n or \r\n, and newlines are found with
+    /// memchr, which is vectorized by most C libraries. A final line without
+    /// a terminator is included if it is not empty. The view refers to the
+    /// buffer, which must remain valid while the view and the lines are used.
+    class indexed_lines_view {
+    public:
+        /// The value_type of our range is the index of the line and its
+        /// contents
+        struct value_type {
+            size_t index;
+            std::string_view value;
+        };
+
+        /// Construct a view over the buffer
+        explicit indexed_lines_view(std::string_view buffer_) noexcept :
+            buffer(buffer_) {}
+
+        /// The iterator for our range
+        class iterator {
+            /// Proxy for ->
+            using arrow_proxy=
+                detail::arrow_proxy<indexed_lines_view::value_type>;
+            /// Proxy for handling *x++
+            using postinc_return=
+                detail::postinc_return<indexed_lines_view::value_type>;
+
+        public:
+            /// Required iterator typedefs
+            using value_type= indexed_lines_view::value_type;
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs
+            using iterator_category= std::input_iterator_tag;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= void;
+
+            /// Compare iterators. Iterators are equal if they refer to the
+            /// same position in the buffer
+            friend bool
+            operator==(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.pos == rhs.pos;
+            }
+            /// Compare iterators
+            friend bool
+            operator!=(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.pos != rhs.pos;
+            }
+
+            /// Dereference the iterator
+            value_type operator*() const noexcept {
+                return value_type{index, line};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const noexcept {
+                return arrow_proxy{**this};
+            }
+
+            /// Get a checkpoint for resuming iteration at this line, holding
+            /// its index and the byte offset of its start
+            indexed_checkpoint checkpoint() const noexcept {
+                return indexed_checkpoint{
+                    index, static_cast<unsigned long long>(pos - begin)};
+            }
+
+            /// Pre-increment
+            iterator &operator++() noexcept {
+                pos= next;
+                ++index;
+                find_line();
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) noexcept {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+        private:
+            friend class indexed_lines_view;
+
+            /// Construct an iterator for the line with the specified index,
+            /// which starts at pos_
+            iterator(
+                char const *begin_, char const *pos_, char const *end_,
+                size_t index_) noexcept :
+                begin(begin_),
+                pos(pos_), end(end_), next(pos_), index(index_) {
+                find_line();
+            }
+
+            /// Find the end of the line starting at pos
+            void find_line() noexcept {
+                if(pos == end)
+                    return;
+                auto const newline= static_cast<char const *>(
+                    memchr(pos, '\n', static_cast<size_t>(end - pos)));
+                if(!newline) {
+                    line= std::string_view(pos, static_cast<size_t>(end - pos));
+                    next= end;
+                    return;
+                }
+                char const *line_end= newline;
+                if((line_end != pos) && (line_end[-1] == '\r'))
+                    --line_end;
+                line= std::string_view(pos, static_cast<size_t>(line_end - pos));
+                next= newline + 1;
+            }
+
+            /// The start of the buffer
+            char const *begin;
+            /// The start of the current line
+            char const *pos;
+            /// The end of the buffer
+            char const *end;
+            /// The start of the next line
+            char const *next;
+            /// The index of the current line
+            size_t index;
+            /// The current line
+            std::string_view line;
+        };
+
+        /// Get an iterator for the first line
+        iterator begin() const noexcept {
+            return iterator(
+                buffer.data(), buffer.data(), buffer.data() + buffer.size(), 0);
+        }
+
+        /// Get an iterator for the end of the buffer
+        iterator end() const noexcept {
+            return iterator(
+                buffer.data(), buffer.data() + buffer.size(),
+                buffer.data() + buffer.size(), 0);
+        }
+
+        /// Get an iterator for the line starting at the byte offset stored
+        /// in the checkpoint, with the index stored in the checkpoint. This
+        /// takes constant time. The checkpoint must come from a view over
+        /// the same buffer; offsets past the end give end()
+        iterator resume(indexed_checkpoint const &checkpoint) const noexcept {
+            if(checkpoint.offset >= buffer.size())
+                return end();
+            return iterator(
+                buffer.data(),
+                buffer.data() + static_cast<size_t>(checkpoint.offset),
+                buffer.data() + buffer.size(), checkpoint.index);
+        }
+
+    private:
+        /// The buffer
+        std::string_view buffer;
+    };
+
+    /// Create a view over the lines in the buffer
+    inline indexed_lines_view indexed_lines(std::string_view buffer) noexcept {
+        return indexed_lines_view(buffer);
+    }
+}
+
+#endif
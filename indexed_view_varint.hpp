@@ -0,0 +1,381 @@
+#ifndef JSS_INDEXED_VIEW_VARINT_HPP
+#define JSS_INDEXED_VIEW_VARINT_HPP
+#include "indexed_view.hpp"
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace jss {
+    /// Encode a range of unsigned integers as a delta/varint stream: the
+    /// difference between each value and the previous one (starting from 0)
+    /// is stored as an unsigned LEB128 varint, with 7 bits per byte and the
+    /// top bit set on all but the last byte. Differences are computed modulo
+    /// 2^64, so decreasing values are allowed, but take 10 bytes.
+    template <typename Range>
+    std::vector<uint8_t> delta_varint_encode(Range const &values) {
+        std::vector<uint8_t> result;
+        uint64_t previous= 0;
+        for(auto const &value : values) {
+            uint64_t delta= static_cast<uint64_t>(value) - previous;
+            previous= static_cast<uint64_t>(value);
+            while(delta >= 0x80) {
+                result.push_back(static_cast<uint8_t>(delta | 0x80));
+                delta>>= 7;
+            }
+            result.push_back(static_cast<uint8_t>(delta));
+        }
+        return result;
+    }
+
+    namespace detail {
+        /// Count the varints in the buffer: the number of bytes without the
+        /// top bit set
+        inline size_t count_varints(uint8_t const *data, size_t size) noexcept {
+            size_t count= 0;
+            for(size_t i= 0; i < size; ++i) {
+                count+= (data[i] < 0x80);
+            }
+            return count;
+        }
+
+        /// Decode a single varint, advancing pos. The varint must be
+        /// terminated before end. Bits beyond 64 are ignored.
+        inline uint64_t decode_varint(uint8_t const *&pos) noexcept {
+            uint8_t byte= *pos++;
+            if(byte < 0x80)
+                return byte;
+            uint64_t result= byte & 0x7f;
+            unsigned shift= 7;
+            do {
+                byte= *pos++;
+                if(shift < 64)
+                    result|= static_cast<uint64_t>(byte & 0x7f) << shift;
+                shift+= 7;
+            } while(byte >= 0x80);
+            return result;
+        }
+    }
+
+    /// A sparse index into a delta/varint stream, recording the byte offset
+    /// and preceding value of every stride-th value, so a view can seek to
+    /// any index by decoding at most stride values
+    class varint_skip_index {
+    public:
+        /// The default number of values between skip entries
+        static constexpr size_t default_stride= 128;
+
+        /// Build the skip index by scanning the stream
+        varint_skip_index(
+            uint8_t const *data, size_t size, size_t stride_= default_stride) :
+            stride(stride_ ? stride_ : 1),
+            count(0) {
+            uint8_t const *pos= data;
+            uint8_t const *const end= data + size;
+            uint64_t value= 0;
+            while(pos != end) {
+                if(!(count % stride)) {
+                    entries.push_back(
+                        entry{static_cast<size_t>(pos - data), value});
+                }
+                uint8_t const *const start= pos;
+                while((pos != end) && (*pos >= 0x80))
+                    ++pos;
+                if(pos == end)
+                    break;
+                ++pos;
+                uint8_t const *decode_pos= start;
+                value+= detail::decode_varint(decode_pos);
+                ++count;
+            }
+        }
+
+        /// The number of values in the stream
+        size_t size() const noexcept {
+            return count;
+        }
+
+        /// The number of values between skip entries
+        size_t get_stride() const noexcept {
+            return stride;
+        }
+
+    private:
+        friend class delta_varint_view;
+
+        /// A skip entry
+        struct entry {
+            /// The byte offset of the value
+            size_t offset;
+            /// The value preceding it
+            uint64_t base;
+        };
+
+        /// The number of values between skip entries
+        size_t stride;
+        /// The number of values in the stream
+        size_t count;
+        /// The skip entries
+        std::vector<entry> entries;
+    };
+
+    /// A view that decodes a delta/varint stream as produced by
+    /// delta_varint_encode, yielding {index,value} pairs directly from the
+    /// encoded bytes. Values are decoded in groups, using SIMD where
+    /// available for groups of single-byte deltas. The view refers to the
+    /// encoded data and the skip index, which must remain valid while the
+    /// view is used.
+    class delta_varint_view {
+    public:
+        /// The number of values decoded at once
+        static constexpr size_t group_size= 16;
+
+        /// The value_type of our range is an index/value pair
+        struct value_type {
+            size_t index;
+            uint64_t value;
+        };
+
+        /// Construct a view over the encoded data. The values are counted up
+        /// front. Without a skip index, seek(k) decodes k values.
+        delta_varint_view(uint8_t const *data_, size_t size_) noexcept :
+            data(data_), data_size(size_),
+            count(detail::count_varints(data_, size_)), skip(nullptr) {}
+
+        /// Construct a view over the encoded data, with a skip index built
+        /// from the same data
+        delta_varint_view(
+            uint8_t const *data_, size_t size_,
+            varint_skip_index const &skip_) noexcept :
+            data(data_),
+            data_size(size_), count(skip_.size()), skip(&skip_) {}
+
+        /// The iterator for our range
+        class iterator {
+            /// Proxy for ->
+            using arrow_proxy=
+                detail::arrow_proxy<delta_varint_view::value_type>;
+            /// Proxy for handling *x++
+            using postinc_return=
+                detail::postinc_return<delta_varint_view::value_type>;
+
+        public:
+            /// Required iterator typedefs
+            using value_type= delta_varint_view::value_type;
+            /// Required iterator typedefs
+            using reference= value_type;
+            /// Required iterator typedefs
+            using iterator_category= std::input_iterator_tag;
+            /// Required iterator typedefs
+            using pointer= value_type *;
+            /// Required iterator typedefs: cannot do std::distance on input
+            /// iterators
+            using difference_type= void;
+
+            /// Compare iterators. Only the indices are compared
+            friend bool
+            operator!=(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.index != rhs.index;
+            }
+            /// Compare iterators. Only the indices are compared
+            friend bool
+            operator==(iterator const &lhs, iterator const &rhs) noexcept {
+                return lhs.index == rhs.index;
+            }
+
+            /// Dereference the iterator
+            value_type operator*() const noexcept {
+                return value_type{index, buffer[buffer_pos]};
+            }
+
+            /// Dereference for iter->m
+            arrow_proxy operator->() const noexcept {
+                return arrow_proxy{**this};
+            }
+
+            /// Get a checkpoint for resuming iteration at this value. Values
+            /// are decoded in groups, so only the index is recorded
+            indexed_checkpoint checkpoint() const noexcept {
+                return indexed_checkpoint{index, 0};
+            }
+
+            /// Pre-increment
+            iterator &operator++() noexcept {
+                ++index;
+                if((++buffer_pos == buffer_size) && (index != count))
+                    refill();
+                return *this;
+            }
+
+            /// Post-increment
+            postinc_return operator++(int) noexcept {
+                postinc_return temp{**this};
+                ++*this;
+                return temp;
+            }
+
+        private:
+            friend class delta_varint_view;
+
+            /// Construct an end iterator
+            explicit iterator(size_t count_) noexcept :
+                pos(nullptr), end(nullptr), index(count_), count(count_),
+                buffer_pos(0), buffer_size(0), last_value(0) {}
+
+            /// Construct an iterator for the value at index_, which starts at
+            /// pos_ and follows base_
+            iterator(
+                uint8_t const *pos_, uint8_t const *end_, size_t index_,
+                size_t count_, uint64_t base_) noexcept :
+                pos(pos_),
+                end(end_), index(index_), count(count_), buffer_pos(0),
+                buffer_size(0), last_value(base_) {
+                if(index != count)
+                    refill();
+            }
+
+            /// Skip forward to the specified index
+            void skip_to(size_t target) noexcept {
+                while((index != count) &&
+                      (target - index >= buffer_size - buffer_pos)) {
+                    index+= buffer_size - buffer_pos;
+                    if(index == count) {
+                        buffer_pos= buffer_size;
+                        return;
+                    }
+                    refill();
+                }
+                buffer_pos+= target - index;
+                index= target;
+            }
+
+            /// Decode the next group of values into the buffer
+            void refill() noexcept {
+                size_t const remaining= count - index;
+                size_t const n= remaining < group_size ? remaining : group_size;
+                buffer_pos= 0;
+                buffer_size= n;
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+                if((n == group_size) && (end - pos >= 16)) {
+                    __m128i const bytes= _mm_loadu_si128(
+                        reinterpret_cast<__m128i const *>(pos));
+                    if(!_mm_movemask_epi8(bytes)) {
+                        decode_single_byte_group(bytes);
+                        pos+= 16;
+                        return;
+                    }
+                }
+#endif
+                uint64_t value= last_value;
+                for(size_t i= 0; i < n; ++i) {
+                    value+= detail::decode_varint(pos);
+                    buffer[i]= value;
+                }
+                last_value= value;
+            }
+
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            /// Decode a group of 16 single-byte deltas with a SIMD prefix sum
+            void decode_single_byte_group(__m128i bytes) noexcept {
+                __m128i const zero= _mm_setzero_si128();
+                __m128i low= _mm_unpacklo_epi8(bytes, zero);
+                __m128i high= _mm_unpackhi_epi8(bytes, zero);
+                low= _mm_add_epi16(low, _mm_slli_si128(low, 2));
+                high= _mm_add_epi16(high, _mm_slli_si128(high, 2));
+                low= _mm_add_epi16(low, _mm_slli_si128(low, 4));
+                high= _mm_add_epi16(high, _mm_slli_si128(high, 4));
+                low= _mm_add_epi16(low, _mm_slli_si128(low, 8));
+                high= _mm_add_epi16(high, _mm_slli_si128(high, 8));
+                __m128i const low_total=
+                    _mm_shufflehi_epi16(low, _MM_SHUFFLE(3, 3, 3, 3));
+                high= _mm_add_epi16(
+                    high, _mm_unpackhi_epi64(low_total, low_total));
+                uint16_t sums[group_size];
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(sums), low);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + 8), high);
+                for(size_t i= 0; i < group_size; ++i) {
+                    buffer[i]= last_value + sums[i];
+                }
+                last_value= buffer[group_size - 1];
+            }
+#endif
+
+            /// The next byte to decode
+            uint8_t const *pos;
+            /// The end of the encoded data
+            uint8_t const *end;
+            /// The current index
+            size_t index;
+            /// The number of values
+            size_t count;
+            /// The position of the current value in the buffer
+            size_t buffer_pos;
+            /// The number of values in the buffer
+            size_t buffer_size;
+            /// The last value decoded
+            uint64_t last_value;
+            /// The decoded values
+            uint64_t buffer[group_size];
+        };
+
+        /// Get an iterator for the first value
+        iterator begin() const noexcept {
+            return iterator(data, data + data_size, 0, count, 0);
+        }
+
+        /// Get an iterator for the end of the range
+        iterator end() const noexcept {
+            return iterator(count);
+        }
+
+        /// Get an iterator for the value at the specified index. With a skip
+        /// index this decodes at most stride values; without one it decodes
+        /// index values.
+        iterator seek(size_t target) const noexcept {
+            if(target >= count)
+                return end();
+            size_t start_index= 0;
+            size_t offset= 0;
+            uint64_t base= 0;
+            if(skip) {
+                size_t const entry= target / skip->stride;
+                start_index= entry * skip->stride;
+                offset= skip->entries[entry].offset;
+                base= skip->entries[entry].base;
+            }
+            iterator result(
+                data + offset, data + data_size, start_index, count, base);
+            result.skip_to(target);
+            return result;
+        }
+
+        /// Get an iterator for the value with the index stored in the
+        /// checkpoint, as for seek()
+        iterator resume(indexed_checkpoint const &checkpoint) const noexcept {
+            return seek(checkpoint.index);
+        }
+
+        /// The number of values
+        size_t size() const noexcept {
+            return count;
+        }
+
+        /// Is the view empty?
+        bool empty() const noexcept {
+            return !count;
+        }
+
+    private:
+        /// The encoded data
+        uint8_t const *data;
+        /// The size of the encoded data
+        size_t data_size;
+        /// The number of values
+        size_t count;
+        /// The skip index, if any
+        varint_skip_index const *skip;
+    };
+}
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef JSS_INDEXED_VIEW_WHERE_HPP
+#define JSS_INDEXED_VIEW_WHERE_HPP
+#include "indexed_view.hpp"
+#include "indexed_view_bits.hpp"
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace jss {
+    namespace detail {
+        /// The number of values whose predicate results are gathered into a
+        /// single mask
+        constexpr size_t compaction_block_size= 64;
+
+        /// The number of matches in a block from which the indices are
+        /// written with the lookup table rather than one set bit at a time
+        constexpr unsigned compaction_dense_threshold= 12;
+
+        /// The positions of the set bits of each 4-bit mask, in order,
+        /// padded with zeros
+        alignas(16) inline constexpr size_t compaction_offsets[16][4]= {
+            {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0},
+            {2, 0, 0, 0}, {0, 2, 0, 0}, {1, 2, 0, 0}, {0, 1, 2, 0},
+            {3, 0, 0, 0}, {0, 3, 0, 0}, {1, 3, 0, 0}, {0, 1, 3, 0},
+            {2, 3, 0, 0}, {0, 2, 3, 0}, {1, 2, 3, 0}, {0, 1, 2, 3}};
+
+        /// The number of set bits in each 4-bit mask
+        inline constexpr unsigned char compaction_counts[16]= {
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+        /// Gather compaction_block_size flags, each 0 or 1, into the bits of
+        /// a mask
+        inline uint64_t
+        compaction_mask(unsigned char const *flags) noexcept {
+            uint64_t mask= 0;
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+            __m128i const zero= _mm_setzero_si128();
+            for(unsigned part= 0; part != compaction_block_size / 16; ++part) {
+                __m128i const bytes= _mm_loadu_si128(
+                    reinterpret_cast<__m128i const *>(flags + part * 16));
+                unsigned const bits=
+                    ~static_cast<unsigned>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero))) &
+                    0xffffu;
+                mask|= static_cast<uint64_t>(bits) << (part * 16);
+            }
+#else
+            for(unsigned i= 0; i != compaction_block_size; ++i) {
+                mask|= static_cast<uint64_t>(flags[i]) << i;
+            }
+#endif
+            return mask;
+        }
+
+        /// Write base_index plus the position of each set bit of mask to
+        /// staging, in order, and return the number written. Each group of
+        /// four bits is expanded with a lookup table and a fixed-size store,
+        /// without branching on the bits, so staging must have room for
+        /// three values more than the number of set bits.
+        inline size_t expand_compaction_mask(
+            uint64_t mask, size_t base_index, size_t *staging) noexcept {
+            size_t count= 0;
+            for(unsigned nibble= 0; nibble != compaction_block_size / 4;
+                ++nibble) {
+                unsigned const bits=
+                    static_cast<unsigned>(mask >> (nibble * 4)) & 15u;
+                size_t const base= base_index + nibble * 4;
+#ifdef JSS_INDEXED_VIEW_HAS_SSE2
+                if constexpr(sizeof(size_t) == 8) {
+                    __m128i const bases=
+                        _mm_set1_epi64x(static_cast<long long>(base));
+                    __m128i const *const offsets=
+                        reinterpret_cast<__m128i const *>(
+                            compaction_offsets[bits]);
+                    __m128i *const target=
+                        reinterpret_cast<__m128i *>(staging + count);
+                    _mm_storeu_si128(
+                        target, _mm_add_epi64(_mm_load_si128(offsets), bases));
+                    _mm_storeu_si128(
+                        target + 1,
+                        _mm_add_epi64(_mm_load_si128(offsets + 1), bases));
+                    count+= compaction_counts[bits];
+                    continue;
+                }
+#endif
+                for(unsigned i= 0; i != 4; ++i) {
+                    staging[count + i]= base + compaction_offsets[bits][i];
+                }
+                count+= compaction_counts[bits];
+            }
+            return count;
+        }
+
+        /// Write the index of each element of a contiguous range of
+        /// arithmetic values for which pred is true to out. The predicate
+        /// results for each block are stored as bytes, in a loop the
+        /// compiler can vectorize for simple predicates, gathered into a
+        /// mask, and then compacted into indices. The index of each element
+        /// is passed to tracker before pred is called for it.
+        template <typename Iterator, typename Predicate, typename Tracker>
+        size_t *indices_where(
+            Iterator const &first, Iterator const &last, Predicate &pred,
+            size_t *out, std::true_type, Tracker tracker) {
+            using element= typename Iterator::value_type;
+            auto const values= get_contiguous_values(first, last);
+            alignas(16) unsigned char flags[compaction_block_size];
+            size_t staging[compaction_block_size + 3];
+            size_t i= 0;
+            for(; i + compaction_block_size <= values.size;
+                i+= compaction_block_size) {
+                auto *const block= values.data + i;
+                size_t const base_index= values.base_index + i;
+                for(size_t j= 0; j != compaction_block_size; ++j) {
+                    tracker.reached(base_index + j);
+                    flags[j]= pred(element{base_index + j, block[j]}) ? 1 : 0;
+                }
+                uint64_t mask= compaction_mask(flags);
+                if(population_count(mask) < compaction_dense_threshold) {
+                    for(; mask; mask&= mask - 1) {
+                        *out++= base_index + count_trailing_zeros(mask);
+                    }
+                } else {
+                    size_t const count=
+                        expand_compaction_mask(mask, base_index, staging);
+                    memcpy(out, staging, count * sizeof(size_t));
+                    out+= count;
+                }
+            }
+            auto *const tail= values.data + i;
+            size_t const tail_index= values.base_index + i;
+            for(size_t j= 0; j != values.size - i; ++j) {
+                tracker.reached(tail_index + j);
+                if(pred(element{tail_index + j, tail[j]}))
+                    *out++= tail_index + j;
+            }
+            return out;
+        }
+
+        /// Write the index of each element in the range [first,last) for
+        /// which pred is true to out, one element at a time, passing the
+        /// index of each element to tracker before pred is called for it
+        template <
+            typename Iterator, typename Predicate, typename OutputIterator,
+            typename Tracker>
+        OutputIterator indices_where(
+            Iterator first, Iterator const &last, Predicate &pred,
+            OutputIterator out, std::false_type, Tracker tracker) {
+            for(; first != last; ++first) {
+                auto &&x= *first;
+                tracker.reached(x.index);
+                if(pred(x))
+                    *out++= x.index;
+            }
+            return out;
+        }
+
+        /// Can indices_where use the contiguous implementation for these
+        /// iterators?
+        template <typename Iterator, typename OutputIterator>
+        using can_compact_contiguous_indices= std::integral_constant<
+            bool, is_contiguous_arithmetic_iterator<Iterator>::value &&
+                      std::is_same<OutputIterator, size_t *>::value>;
+
+        /// Count the elements in the range [first,last) for which pred is
+        /// true, passing the index of each element to tracker before pred is
+        /// called for it
+        template <typename Iterator, typename Predicate, typename Tracker>
+        size_t count_where(
+            Iterator first, Iterator const &last, Predicate &pred,
+            Tracker tracker) {
+            if constexpr(is_contiguous_arithmetic_iterator<Iterator>::value) {
+                using element= typename Iterator::value_type;
+                auto const values= get_contiguous_values(first, last);
+                size_t count= 0;
+                for(size_t i= 0; i != values.size; ++i) {
+                    tracker.reached(values.base_index + i);
+                    count+=
+                        pred(element{values.base_index + i, values.data[i]}) ?
+                            1 :
+                            0;
+                }
+                return count;
+            } else {
+                size_t count= 0;
+                for(; first != last; ++first) {
+                    auto &&x= *first;
+                    tracker.reached(x.index);
+                    if(pred(x))
+                        ++count;
+                }
+                return count;
+            }
+        }
+    }
+
+    /// Write the index of each element x of the view for which pred(x) is
+    /// true to out, in order, and return the end of the written indices, as
+    /// for std::copy_if. The buffer must have room for all the matching
+    /// indices, which can be found with count_where. If out is a size_t*
+    /// and the view is over a contiguous range of arithmetic values, the
+    /// predicate is evaluated a block of 64 elements at a time, and the
+    /// matching indices are compacted from a mask of the results with
+    /// SIMD instructions where available.
+    template <typename View, typename Predicate, typename OutputIterator>
+    OutputIterator
+    indices_where(View &&view, Predicate pred, OutputIterator out) {
+        auto first= view.begin();
+        auto last= view.end();
+        return detail::indices_where(
+            first, last, pred, std::move(out),
+            detail::can_compact_contiguous_indices<
+                decltype(first), OutputIterator>(),
+            detail::no_element_tracker());
+    }
+
+    /// Count the elements x of the view for which pred(x) is true, to size
+    /// the buffer for indices_where
+    template <typename View, typename Predicate>
+    size_t count_where(View &&view, Predicate pred) {
+        auto first= view.begin();
+        auto last= view.end();
+        return detail::count_where(
+            first, last, pred, detail::no_element_tracker());
+    }
+}
+
+#endif
@@ -5,9 +5,87 @@
 #include <string>
 #include <deque>
 #include <algorithm>
+#include <sstream>
+#include <iterator>
+#include <array>
+#include <list>
+#include <memory>
+
+#ifdef JSS_INDEXED_VIEW_COUNT_ALLOCATIONS
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+std::atomic<size_t> allocations(0);
+
+void *operator new(size_t size) {
+    ++allocations;
+    if(void *p= malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    ++allocations;
+    size_t const align= static_cast<size_t>(alignment);
+    size= size ? (size + align - 1) / align * align : align;
+#ifdef _MSC_VER
+    if(void *p= _aligned_malloc(size, align))
+#else
+    if(void *p= aligned_alloc(align, size))
+#endif
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+size_t allocation_count() {
+    return allocations.load();
+}
+#else
+size_t allocation_count() {
+    return 0;
+}
+#endif
+
+/// Assert that no heap allocations happen between construction and
+/// destruction. This only checks anything when built with
+/// JSS_INDEXED_VIEW_COUNT_ALLOCATIONS, which replaces the global operator
+/// new and delete with counting versions.
+struct no_allocation_guard {
+    size_t const initial= allocation_count();
+
+    ~no_allocation_guard() {
+        assert(allocation_count() == initial);
+    }
+};
 
 void test_indexed_view_is_empty_for_empty_vector() {
     std::vector<int> v;
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     assert(view.begin() == view.end());
@@ -15,6 +93,7 @@ void test_indexed_view_is_empty_for_empty_vector() {
 
 void test_indexed_view_iterator_has_index_and_value_of_source() {
     std::vector<int> v;
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     static_assert(
@@ -31,6 +110,7 @@ void test_indexed_view_iterator_has_index_and_value_of_source() {
 
 void test_dereferencing_begin_iterator_of_indexed_view_gives_0_and_element() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     assert((*view.begin()).index == 0);
@@ -39,12 +119,14 @@ void test_dereferencing_begin_iterator_of_indexed_view_gives_0_and_element() {
 
 void test_begin_and_end_of_non_empty_range_are_not_equal() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
     assert(!(view.begin() == view.end()));
 }
 
 void test_can_use_arrow_operator_on_iterator() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     assert(view.begin()->index == 0);
@@ -59,6 +141,7 @@ void test_can_use_arrow_operator_on_iterator() {
 
 void test_can_increment_view_iterator() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     assert(view.begin()->index == 0);
@@ -72,6 +155,7 @@ void test_can_increment_view_iterator() {
 
 void test_preincrement_view_iterator() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     assert(view.begin()->index == 0);
@@ -87,6 +171,9 @@ void test_preincrement_view_iterator() {
 
 void test_view_iterator_has_iterator_properties() {
     std::vector<int> v{42, 56, 99};
+    std::deque<int> d{42, 56, 99};
+    std::istringstream is("1 2 3");
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
     static_assert(
         std::is_same<
@@ -101,16 +188,38 @@ void test_view_iterator_has_iterator_properties() {
     static_assert(
         std::is_same<
             typename decltype(view.begin())::iterator_category,
+            std::random_access_iterator_tag>::value,
+        "Random-access iterators for random-access sources");
+    static_assert(
+        std::is_same<
+            typename decltype(view.begin())::difference_type,
+            ptrdiff_t>::value,
+        "Difference type for random-access sources");
+
+    auto deque_view= jss::indexed_view(d.begin(), d.begin() + 2);
+    static_assert(
+        std::is_same<
+            typename decltype(deque_view.begin())::iterator_category,
+            std::random_access_iterator_tag>::value,
+        "Random-access iterators for random-access sources");
+
+    auto input_view= jss::indexed_view(
+        std::istream_iterator<int>(is), std::istream_iterator<int>());
+    static_assert(
+        std::is_same<
+            typename decltype(input_view.begin())::iterator_category,
             std::input_iterator_tag>::value,
         "Input iterators");
     static_assert(
         std::is_same<
-            typename decltype(view.begin())::difference_type, void>::value,
+            typename decltype(input_view.begin())::difference_type,
+            void>::value,
         "No difference type");
 }
 
 void test_view_iterator_equality_comparisons() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     auto it= view.begin();
@@ -131,6 +240,8 @@ void test_view_iterator_with_range_for() {
     std::string const source[]= {"hello", "goodbye", "analysis", "dungeon"};
 
     std::vector<std::pair<size_t, std::string>> output;
+    output.reserve(4);
+    no_allocation_guard guard;
 
     for(auto &x : jss::indexed_view(source)) {
         output.push_back({x.index, x.value});
@@ -146,6 +257,7 @@ void test_view_iterator_with_range_for() {
 void test_can_write_through_value_in_range_for() {
     unsigned const count= 5;
     int values[count]= {0};
+    no_allocation_guard guard;
 
     for(auto &x : jss::indexed_view(values)) {
         x.value= x.index * 2;
@@ -283,6 +395,8 @@ void test_can_index_input_ranges() {
 
     unsigned const base= 5;
     unsigned const count= 20;
+    output.reserve(count);
+    no_allocation_guard guard;
 
     for(auto &x : jss::indexed_view(range(base, base + count))) {
         output.push_back({x.index, x.value});
@@ -350,6 +464,7 @@ struct my_range {
 
 void test_can_index_ranges_with_sentinels() {
     my_range r;
+    no_allocation_guard guard;
 
     unsigned i= 0;
 
@@ -365,6 +480,7 @@ void test_can_index_ranges_with_sentinels() {
 
 void test_can_index_iterator_pairs() {
     std::deque<int> const d= {1, 45, 67, 98, 123, -45};
+    no_allocation_guard guard;
 
     unsigned count= 0;
     for(auto &x : jss::indexed_view(d.begin(), d.end())) {
@@ -375,8 +491,24 @@ void test_can_index_iterator_pairs() {
     assert(count == d.size());
 }
 
+void test_can_index_lists() {
+    std::list<int> l= {3, 1, 4, 1, 5};
+    no_allocation_guard guard;
+
+    unsigned count= 0;
+    auto it= l.begin();
+    for(auto &x : jss::indexed_view(l)) {
+        assert(x.index == count);
+        assert(&x.value == &*it);
+        ++it;
+        ++count;
+    }
+    assert(count == l.size());
+}
+
 void test_can_index_iterator_sentinel_pairs() {
     my_range r;
+    no_allocation_guard guard;
 
     unsigned i= 0;
 
@@ -390,6 +522,7 @@ void test_can_index_iterator_sentinel_pairs() {
 
 void test_can_reuse_view_if_underlying_range_stable() {
     std::vector<int> v{42, 56, 99};
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
     unsigned i= 0;
 
@@ -412,6 +545,7 @@ void test_can_reuse_view_if_underlying_range_stable() {
 void test_can_use_view_with_standard_algorithms() {
     std::vector<int> v;
     v.resize(100);
+    no_allocation_guard guard;
     auto view= jss::indexed_view(v);
 
     std::for_each(view.begin(), view.end(), [](auto &x) { x.value= x.index; });
@@ -504,6 +638,7 @@ unsigned my_tracked_range::sentinel_destruct= 0;
 
 void test_properly_handle_iterator_and_sentinel_lifetime() {
     my_tracked_range r;
+    no_allocation_guard guard;
 
     unsigned i= 0;
 
@@ -542,6 +677,674 @@ void test_properly_handle_iterator_and_sentinel_lifetime() {
         my_tracked_range::sentinel_destruct);
 }
 
+void test_can_index_counted_ranges() {
+    std::vector<int> v{42, 56, 99, 123};
+    no_allocation_guard guard;
+
+    unsigned count= 0;
+    for(auto &x : jss::indexed_view_n(v.begin(), 3)) {
+        assert(x.index == count);
+        assert(&x.value == &v[count]);
+        ++count;
+    }
+    assert(count == 3);
+
+    auto empty_view= jss::indexed_view_n(v.begin(), 0);
+    assert(empty_view.begin() == empty_view.end());
+}
+
+void test_can_index_counted_input_ranges() {
+    std::istringstream is("10 20 30 40");
+
+    std::vector<std::pair<size_t, int>> output;
+    output.reserve(4);
+    no_allocation_guard guard;
+    for(auto &x :
+        jss::indexed_view_n(std::istream_iterator<int>(is), 4)) {
+        output.push_back({x.index, x.value});
+    }
+
+    assert(output.size() == 4);
+    for(unsigned i= 0; i < output.size(); ++i) {
+        assert(output[i].first == i);
+        assert(output[i].second == static_cast<int>((i + 1) * 10));
+    }
+}
+
+struct uncomparable_iterator {
+    size_t value;
+
+    size_t operator*() const {
+        return value;
+    }
+
+    uncomparable_iterator &operator++() {
+        ++value;
+        return *this;
+    }
+};
+
+void test_counted_view_does_not_compare_underlying_iterators() {
+    unsigned const count= 5;
+    unsigned i= 0;
+    no_allocation_guard guard;
+
+    for(auto x : jss::indexed_view_n(uncomparable_iterator{7}, count)) {
+        assert(x.index == i);
+        assert(x.value == i + 7);
+        ++i;
+    }
+    assert(i == count);
+}
+
+void test_random_access_views_terminate_on_index() {
+    std::vector<int> v{42, 56, 99, 123};
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(v.begin() + 1, v.end());
+
+    static_assert(
+        std::is_same<
+            decltype(view)::iterator,
+            decltype(jss::indexed_view_n(v.begin(), 3))::iterator>::value,
+        "Random-access views use index-terminated iterators");
+
+    unsigned count= 0;
+    for(auto &x : view) {
+        assert(x.index == count);
+        assert(&x.value == &v[count + 1]);
+        ++count;
+    }
+    assert(count == 3);
+
+    auto empty_view= jss::indexed_view(v.end(), v.end());
+    assert(empty_view.begin() == empty_view.end());
+}
+
+void test_random_access_view_iterator_operations() {
+    std::vector<int> v{42, 56, 99, 123, 7};
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(v);
+
+    auto it= view.begin();
+    auto const end= view.end();
+    assert(end - it == 5);
+    assert(it < end);
+    assert(!(end < it));
+    assert(it <= it);
+    assert(end >= it);
+    assert(end > it);
+
+    it+= 3;
+    assert(it->index == 3);
+    assert(&it->value == &v[3]);
+    assert(end - it == 2);
+
+    --it;
+    assert(it->index == 2);
+    assert(&it->value == &v[2]);
+
+    auto it2= it - 2;
+    assert(it2 == view.begin());
+    assert((it2 + 4)->index == 4);
+    assert(&(2 + it2)->value == &v[2]);
+    assert(it2[3].index == 3);
+    assert(&it2[3].value == &v[3]);
+
+    assert(std::distance(view.begin(), view.end()) == 5);
+
+    auto counted= jss::indexed_view_n(v.begin() + 1, 3);
+    assert(counted.end() - counted.begin() == 3);
+    assert(counted.begin()[2].index == 2);
+    assert(&counted.begin()[2].value == &v[3]);
+}
+
+/// Can values be assigned and swapped through references of type
+/// Reference, as required by std::sort and std::reverse?
+template <typename Reference>
+constexpr bool can_modify_through=
+    std::is_assignable<Reference, Reference>::value ||
+    std::is_swappable_with<Reference, Reference>::value;
+
+void test_random_access_views_are_read_only_for_std_algorithms() {
+    std::vector<int> v{5, 8, 13, 21, 34, 55};
+    auto view= jss::indexed_view(v);
+    static_assert(!can_modify_through<decltype(*view.begin())>);
+    static_assert(
+        !can_modify_through<decltype(*jss::indexed_view_n(v.begin(), 3)
+                                          .begin())>);
+    static_assert(can_modify_through<decltype(*v.begin())>);
+
+    no_allocation_guard guard;
+    auto const found= std::find_if(
+        view.begin(), view.end(), [](auto x) { return x.value > 10; });
+    assert(found->index == 2);
+    assert(
+        std::count_if(view.begin(), view.end(), [](auto x) {
+            return x.value % 2;
+        }) == 4);
+    auto const point= std::partition_point(
+        view.begin(), view.end(), [](auto x) { return x.value < 30; });
+    assert(point - view.begin() == 4);
+    assert(&point->value == &v[4]);
+}
+
+/// This test has no no_allocation_guard, as the OpenMP runtime allocates
+/// its thread team on first use
+void test_can_use_view_with_openmp_parallel_for() {
+#ifdef _OPENMP
+    std::vector<size_t> v(1000);
+    auto view= jss::indexed_view(v);
+
+#pragma omp parallel for schedule(static)
+    for(auto it= view.begin(); it < view.end(); ++it) {
+        it->value= it->index;
+    }
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == i);
+    }
+
+#pragma omp parallel for schedule(dynamic, 7)
+    for(auto it= view.begin(); it != view.end(); ++it) {
+        it->value= it->index * 2;
+    }
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == i * 2);
+    }
+
+#pragma omp parallel for schedule(guided)
+    for(auto it= view.begin(); it < view.end(); it+= 3) {
+        it->value= it->index * 3;
+    }
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == ((i % 3) ? i * 2 : i * 3));
+    }
+#endif
+}
+
+void test_random_access_views_are_splittable() {
+    std::vector<int> v{42, 56, 99, 123, 7};
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(v);
+
+    assert(view.size() == 5);
+    assert(!view.empty());
+    assert(view.is_divisible());
+
+    decltype(view) second(view, jss::split());
+    assert(view.size() == 2);
+    assert(second.size() == 3);
+    assert(view.begin()->index == 0);
+    assert(second.begin()->index == 2);
+    assert(&second.begin()->value == &v[2]);
+    assert(view.end() == second.begin());
+
+    unsigned i= 2;
+    for(auto &x : second) {
+        assert(x.index == i);
+        assert(&x.value == &v[i]);
+        ++i;
+    }
+    assert(i == v.size());
+
+    decltype(view) last(second, jss::split());
+    assert(second.size() == 1);
+    assert(!second.is_divisible());
+    assert(last.begin()->index == 3);
+
+    auto empty_view= jss::indexed_view(v.end(), v.end());
+    assert(empty_view.empty());
+    assert(!empty_view.is_divisible());
+}
+
+void test_random_access_views_can_be_split_in_proportion() {
+    std::vector<int> v(100);
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(v);
+    static_assert(
+        decltype(view)::is_splittable_in_proportion,
+        "Views are splittable in proportion");
+
+    decltype(view) second(view, jss::proportional_split(1, 3));
+    assert(view.size() == 25);
+    assert(second.size() == 75);
+    assert(second.begin()->index == 25);
+    assert(&second.begin()->value == &v[25]);
+
+    auto small= jss::indexed_view(v.begin(), v.begin() + 2);
+    decltype(small) small_second(small, jss::proportional_split(1, 1000));
+    assert(small.size() == 1);
+    assert(small_second.size() == 1);
+    assert(small_second.begin()->index == 1);
+}
+
+/// A split tag from a third-party scheduler
+struct other_split_tag {};
+
+/// A proportional split tag from a third-party scheduler
+struct other_proportional_split_tag {
+    size_t left() const {
+        return 3;
+    }
+    size_t right() const {
+        return 1;
+    }
+};
+
+void test_only_split_tags_split_views() {
+    std::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8};
+    using view_type= decltype(jss::indexed_view(v));
+    static_assert(
+        std::is_constructible<view_type, view_type &, jss::split>::value);
+    static_assert(std::is_constructible<
+                  view_type, view_type &, jss::proportional_split>::value);
+    static_assert(
+        std::is_constructible<view_type, view_type &, other_split_tag>::value);
+    static_assert(std::is_constructible<
+                  view_type, view_type &, other_proportional_split_tag>::value);
+    static_assert(!std::is_constructible<view_type, view_type &, int>::value);
+    static_assert(
+        !std::is_constructible<view_type, view_type &, size_t>::value);
+    static_assert(!std::is_constructible<
+                  view_type, view_type &, std::vector<int>::iterator>::value);
+    static_assert(!std::is_constructible<
+                  view_type, view_type &, std::istream_iterator<int>>::value);
+    static_assert(
+        !std::is_constructible<view_type, view_type &, int *>::value);
+    static_assert(
+        !std::is_constructible<view_type, view_type &, std::string>::value);
+
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(v);
+    view_type second(view, other_split_tag());
+    assert(view.size() == 4);
+    view_type third(second, other_proportional_split_tag());
+    assert(second.size() == 3);
+    assert(third.begin()->index == 7);
+}
+
+template <typename View>
+void recursively_split_and_mark(View view, std::vector<unsigned> &counts) {
+    if(view.is_divisible()) {
+        View second(view, jss::split());
+        recursively_split_and_mark(view, counts);
+        recursively_split_and_mark(second, counts);
+    } else {
+        for(auto &x : view) {
+            assert(x.value == static_cast<int>(x.index));
+            ++counts[x.index];
+        }
+    }
+}
+
+void test_recursive_bisection_visits_each_index_once() {
+    std::vector<int> v(37);
+    for(auto &x : jss::indexed_view(v)) {
+        x.value= static_cast<int>(x.index);
+    }
+
+    std::vector<unsigned> counts(v.size());
+    no_allocation_guard guard;
+    recursively_split_and_mark(jss::indexed_view(v), counts);
+    for(auto count : counts) {
+        assert(count == 1);
+    }
+}
+
+void test_owning_view_stores_only_the_range() {
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(std::array<int, 4>{{1, 2, 3, 4}});
+    static_assert(
+        sizeof(view) == sizeof(std::array<int, 4>),
+        "Owning view holds only the range");
+
+    auto moved= std::move(view);
+    unsigned count= 0;
+    for(auto x : moved) {
+        assert(x.index == count);
+        assert(x.value == static_cast<int>(count + 1));
+        ++count;
+    }
+    assert(count == 4);
+}
+
+void test_owning_view_iterators_refer_to_own_copy_after_copy() {
+    no_allocation_guard guard;
+    auto view= jss::indexed_view(std::array<int, 3>{{1, 2, 3}});
+    auto copy= view;
+
+    for(auto x : copy) {
+        x.value= 0;
+    }
+    for(auto x : view) {
+        assert(x.value == static_cast<int>(x.index + 1));
+    }
+    for(auto x : copy) {
+        assert(x.value == 0);
+    }
+}
+
+decltype(jss::indexed_view(std::array<int, 3>())) make_owning_view() {
+    auto view= jss::indexed_view(std::array<int, 3>{{7, 8, 9}});
+    auto copy= view;
+    return copy;
+}
+
+void test_owning_view_can_be_returned_from_functions() {
+    no_allocation_guard guard;
+    auto view= make_owning_view();
+    assert(view.size() == 3);
+    unsigned count= 0;
+    for(auto x : view) {
+        assert(x.index == count);
+        assert(x.value == static_cast<int>(count + 7));
+        ++count;
+    }
+    assert(count == 3);
+}
+
+void test_shared_view_copies_share_the_range() {
+    std::vector<int> batch{1, 2, 3, 4, 5};
+    int const *const data= batch.data();
+    auto view= jss::shared_indexed_view(std::move(batch));
+    no_allocation_guard guard;
+    auto copy= view;
+
+    assert(view.get_range() == copy.get_range());
+    assert(view.get_range().use_count() == 2);
+    assert(view.get_range()->data() == data);
+    assert(view.size() == 5);
+
+    unsigned count= 0;
+    for(auto x : copy) {
+        assert(x.index == count);
+        assert(&x.value == &(*view.get_range())[count]);
+        ++count;
+    }
+    assert(count == 5);
+}
+
+void test_shared_view_slices_keep_indices() {
+    auto view= jss::shared_indexed_view(std::vector<int>{10, 11, 12, 13, 14, 15});
+    no_allocation_guard guard;
+
+    auto slice= view.slice(2, 3);
+    assert(slice.get_range() == view.get_range());
+    assert(slice.size() == 3);
+    unsigned count= 0;
+    for(auto x : slice) {
+        assert(x.index == count + 2);
+        assert(x.value == static_cast<int>(count + 12));
+        ++count;
+    }
+    assert(count == 3);
+
+    auto inner= slice.slice(1, 10);
+    assert(inner.size() == 2);
+    assert(inner.begin()->index == 3);
+    assert(inner.begin()->value == 13);
+
+    auto empty= slice.slice(5, 1);
+    assert(empty.empty());
+    assert(empty.begin() == empty.end());
+}
+
+void test_shared_view_can_share_existing_pointer() {
+    auto data= std::make_shared<std::list<int>>(std::list<int>{3, 4, 5});
+    auto view= jss::shared_indexed_view(data);
+    no_allocation_guard guard;
+    assert(view.get_range() == data);
+
+    unsigned count= 0;
+    for(auto x : view) {
+        assert(x.index == count);
+        assert(x.value == static_cast<int>(count + 3));
+        ++count;
+    }
+    assert(count == 3);
+}
+
+void test_checkpoint_round_trips_through_stream() {
+    jss::indexed_checkpoint checkpoint{42, 1234};
+    std::ostringstream os;
+    os << checkpoint;
+    assert(os.str() == "42 1234");
+
+    std::istringstream is(os.str());
+    jss::indexed_checkpoint restored{0, 0};
+    is >> restored;
+    assert(is);
+    assert(restored.index == 42);
+    assert(restored.offset == 1234);
+}
+
+void test_can_resume_random_access_view_from_checkpoint() {
+    std::vector<int> v{10, 11, 12, 13, 14, 15};
+    auto view= jss::indexed_view(v);
+    auto it= view.begin();
+    ++it;
+    ++it;
+    std::ostringstream os;
+    os << it.checkpoint();
+
+    std::istringstream is(os.str());
+    jss::indexed_checkpoint checkpoint;
+    is >> checkpoint;
+    no_allocation_guard guard;
+    auto resumed= view.resume(checkpoint);
+    assert(resumed == it);
+    unsigned count= 2;
+    for(; resumed != view.end(); ++resumed) {
+        assert(resumed->index == count);
+        assert(resumed->value == static_cast<int>(count + 10));
+        ++count;
+    }
+    assert(count == 6);
+    assert(view.resume(jss::indexed_checkpoint{6, 0}) == view.end());
+    assert(view.resume(jss::indexed_checkpoint{100, 0}) == view.end());
+}
+
+void test_resuming_slice_uses_original_indices() {
+    auto view= jss::shared_indexed_view(std::vector<int>{10, 11, 12, 13, 14, 15});
+    auto slice= view.slice(2, 3);
+    auto it= slice.resume(jss::indexed_checkpoint{3, 0});
+    assert(it->index == 3);
+    assert(it->value == 13);
+    assert(slice.resume(jss::indexed_checkpoint{0, 0}) == slice.begin());
+    assert(slice.resume(jss::indexed_checkpoint{5, 0}) == slice.end());
+}
+
+void test_can_resume_non_random_access_view_from_checkpoint() {
+    std::list<int> l{3, 1, 4, 1, 5};
+    auto view= jss::indexed_view(l);
+    auto position= view.begin();
+    for(unsigned i= 0; i < 3; ++i)
+        ++position;
+    auto checkpoint= position.checkpoint();
+    assert(checkpoint.index == 3);
+    assert(checkpoint.offset == 0);
+    auto it= view.resume(checkpoint);
+    assert(it->index == 3);
+    assert(it->value == 1);
+    ++it;
+    assert(it->index == 4);
+    assert(it->value == 5);
+    assert(view.resume(jss::indexed_checkpoint{5, 0}) == view.end());
+}
+
+void test_can_resume_counted_and_owning_views_from_checkpoint() {
+    std::vector<int> v{5, 6, 7, 8};
+    auto counted= jss::indexed_view_n(v.begin(), 3);
+    auto position= counted.begin();
+    ++position;
+    auto it= counted.resume(position.checkpoint());
+    assert(it->index == 1);
+    assert(it->value == 6);
+    assert(counted.resume(jss::indexed_checkpoint{3, 0}) == counted.end());
+
+    auto owning= jss::indexed_view(std::vector<int>{20, 21, 22});
+    auto owned_it= owning.resume(jss::indexed_checkpoint{2, 0});
+    assert(owned_it->index == 2);
+    assert(owned_it->value == 22);
+
+    auto shared= jss::shared_indexed_view(std::list<int>{30, 31, 32});
+    auto shared_it= shared.resume(jss::indexed_checkpoint{1, 0});
+    assert(shared_it->index == 1);
+    assert(shared_it->value == 31);
+}
+
+/// A forward iterator over a list that counts the number of increments
+struct counting_forward_iterator {
+    using iterator_category= std::forward_iterator_tag;
+    using value_type= int;
+    using difference_type= ptrdiff_t;
+    using pointer= int const *;
+    using reference= int const &;
+
+    std::list<int>::const_iterator source;
+    size_t *increments;
+
+    reference operator*() const {
+        return *source;
+    }
+
+    counting_forward_iterator &operator++() {
+        ++*increments;
+        ++source;
+        return *this;
+    }
+
+    counting_forward_iterator operator++(int) {
+        counting_forward_iterator old= *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(
+        counting_forward_iterator const &lhs,
+        counting_forward_iterator const &rhs) {
+        return lhs.source == rhs.source;
+    }
+
+    friend bool operator!=(
+        counting_forward_iterator const &lhs,
+        counting_forward_iterator const &rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+void test_skip_index_recorded_during_iteration_bounds_resume() {
+    std::list<int> l;
+    for(int i= 0; i < 10000; ++i)
+        l.push_back(i * 2);
+    size_t increments= 0;
+    auto view= jss::indexed_view(
+        counting_forward_iterator{l.begin(), &increments},
+        counting_forward_iterator{l.end(), &increments});
+    jss::indexed_skip_index<decltype(view.begin())> skip_index(100);
+    assert(skip_index.get_stride() == 100);
+    for(auto it= view.begin(); it != view.end(); ++it)
+        skip_index.record(it);
+    assert(skip_index.size() == 100);
+
+    no_allocation_guard guard;
+    increments= 0;
+    auto it= view.resume(jss::indexed_checkpoint{5050, 0}, skip_index);
+    assert(it->index == 5050);
+    assert(it->value == 10100);
+    assert(increments <= 100);
+
+    increments= 0;
+    it= view.resume(jss::indexed_checkpoint{9999, 0}, skip_index);
+    assert(it->index == 9999);
+    assert(increments <= 100);
+
+    increments= 0;
+    assert(
+        view.resume(jss::indexed_checkpoint{10000, 0}, skip_index) ==
+        view.end());
+    assert(
+        view.resume(jss::indexed_checkpoint{50000, 0}, skip_index) ==
+        view.end());
+    assert(increments <= 200);
+}
+
+void test_resuming_with_skip_index_records_positions() {
+    std::list<int> l;
+    for(int i= 0; i < 1000; ++i)
+        l.push_back(i);
+    size_t increments= 0;
+    auto view= jss::indexed_view(
+        counting_forward_iterator{l.begin(), &increments},
+        counting_forward_iterator{l.end(), &increments});
+    jss::indexed_skip_index<decltype(view.begin())> skip_index(10);
+    assert(!skip_index.nearest(5));
+
+    auto it= view.resume(jss::indexed_checkpoint{500, 0}, skip_index);
+    assert(it->index == 500);
+    assert(it->value == 500);
+    assert(increments == 500);
+    assert(skip_index.size() == 51);
+
+    increments= 0;
+    it= view.resume(jss::indexed_checkpoint{499, 0}, skip_index);
+    assert(it->index == 499);
+    assert(increments == 9);
+
+    increments= 0;
+    it= view.resume(jss::indexed_checkpoint{0, 0}, skip_index);
+    assert(it == view.begin());
+    assert(increments == 0);
+
+    jss::indexed_skip_index<decltype(view.begin())> zero_stride(0);
+    assert(zero_stride.get_stride() == 1);
+}
+
+void test_can_resume_other_views_with_skip_index() {
+    std::list<int> l{10, 11, 12, 13, 14, 15, 16, 17};
+    auto counted= jss::indexed_view_n(l.begin(), 6);
+    jss::indexed_skip_index<decltype(counted.begin())> counted_skip(2);
+    auto it= counted.resume(jss::indexed_checkpoint{5, 0}, counted_skip);
+    assert(it->index == 5);
+    assert(it->value == 15);
+    assert(counted_skip.size() == 3);
+    assert(
+        counted.resume(jss::indexed_checkpoint{6, 0}, counted_skip) ==
+        counted.end());
+    it= counted.resume(jss::indexed_checkpoint{3, 0}, counted_skip);
+    assert(it->index == 3);
+    assert(it->value == 13);
+
+    std::vector<int> v{20, 21, 22, 23};
+    auto random_counted= jss::indexed_view_n(v.begin(), 3);
+    jss::indexed_skip_index<decltype(random_counted.begin())> random_skip;
+    assert(
+        random_counted.resume(jss::indexed_checkpoint{2, 0}, random_skip)
+            ->value == 22);
+    assert(random_skip.size() == 0);
+
+    auto owning= jss::indexed_view(std::list<int>{30, 31, 32});
+    jss::indexed_skip_index<decltype(owning.begin())> owning_skip(1);
+    assert(
+        owning.resume(jss::indexed_checkpoint{2, 0}, owning_skip)->value == 32);
+    assert(owning_skip.size() == 3);
+
+    auto shared= jss::shared_indexed_view(std::list<int>{40, 41, 42});
+    jss::indexed_skip_index<decltype(shared.begin())> shared_skip(2);
+    auto shared_it= shared.resume(jss::indexed_checkpoint{1, 0}, shared_skip);
+    assert(shared_it->index == 1);
+    assert(shared_it->value == 41);
+    auto copy= shared;
+    assert(
+        copy.resume(jss::indexed_checkpoint{2, 0}, shared_skip)->value == 42);
+
+    auto random= jss::indexed_view(v);
+    jss::indexed_skip_index<decltype(random.begin())> random_view_skip;
+    assert(
+        random.resume(jss::indexed_checkpoint{3, 0}, random_view_skip)
+            ->value == 23);
+    assert(random_view_skip.size() == 0);
+}
+
 int main() {
     test_indexed_view_is_empty_for_empty_vector();
     test_indexed_view_iterator_has_index_and_value_of_source();
@@ -551,14 +1354,40 @@ int main() {
     test_can_increment_view_iterator();
     test_preincrement_view_iterator();
     test_view_iterator_has_iterator_properties();
+    test_random_access_views_are_read_only_for_std_algorithms();
     test_view_iterator_equality_comparisons();
     test_view_iterator_with_range_for();
     test_can_write_through_value_in_range_for();
     test_can_index_input_ranges();
     test_can_index_ranges_with_sentinels();
     test_can_index_iterator_pairs();
+    test_can_index_lists();
     test_can_index_iterator_sentinel_pairs();
     test_can_reuse_view_if_underlying_range_stable();
     test_can_use_view_with_standard_algorithms();
     test_properly_handle_iterator_and_sentinel_lifetime();
+    test_can_index_counted_ranges();
+    test_can_index_counted_input_ranges();
+    test_counted_view_does_not_compare_underlying_iterators();
+    test_random_access_views_terminate_on_index();
+    test_random_access_view_iterator_operations();
+    test_can_use_view_with_openmp_parallel_for();
+    test_random_access_views_are_splittable();
+    test_random_access_views_can_be_split_in_proportion();
+    test_only_split_tags_split_views();
+    test_recursive_bisection_visits_each_index_once();
+    test_owning_view_stores_only_the_range();
+    test_owning_view_iterators_refer_to_own_copy_after_copy();
+    test_owning_view_can_be_returned_from_functions();
+    test_shared_view_copies_share_the_range();
+    test_shared_view_slices_keep_indices();
+    test_shared_view_can_share_existing_pointer();
+    test_checkpoint_round_trips_through_stream();
+    test_can_resume_random_access_view_from_checkpoint();
+    test_resuming_slice_uses_original_indices();
+    test_can_resume_non_random_access_view_from_checkpoint();
+    test_can_resume_counted_and_owning_views_from_checkpoint();
+    test_skip_index_recorded_during_iteration_bounds_resume();
+    test_resuming_with_skip_index_records_positions();
+    test_can_resume_other_views_with_skip_index();
 }
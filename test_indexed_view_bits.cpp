@@ -0,0 +1,177 @@
+#include "indexed_view_bits.hpp"
+#include <assert.h>
+#include <array>
+#include <vector>
+#include <stdint.h>
+
+#if defined(JSS_INDEXED_VIEW_PORTABLE_BIT_VECTOR) &&                           \
+    defined(JSS_INDEXED_VIEW_HAS_BIT_VECTOR_WORDS)
+#error The portable build must pack the bits of std::vector<bool>
+#endif
+
+template <typename View> std::vector<size_t> collect(View const &view) {
+    std::vector<size_t> output;
+    size_t count= 0;
+    for(auto x : view) {
+        assert(x.index == count);
+        ++count;
+        output.push_back(x.value);
+    }
+    return output;
+}
+
+void test_set_bit_indices_of_words() {
+    std::vector<uint64_t> words{0x8000000000000005ull, 0, 0x10};
+
+    auto view= jss::set_bit_indices(words);
+
+    assert((collect(view) == std::vector<size_t>{0, 2, 63, 132}));
+    assert(view.size() == 4);
+    assert(!view.empty());
+}
+
+void test_set_bit_indices_of_empty_and_zero_words() {
+    std::vector<uint64_t> none;
+    std::vector<uint64_t> zeros(100);
+
+    assert(collect(jss::set_bit_indices(none)).empty());
+    assert(jss::set_bit_indices(none).empty());
+    assert(collect(jss::set_bit_indices(zeros)).empty());
+    assert(jss::set_bit_indices(zeros).size() == 0);
+}
+
+void test_set_bit_indices_skips_long_runs_of_zero_words() {
+    std::vector<uint64_t> words(1000);
+    words[0]= 1;
+    words[3]= 2;
+    words[500]= 0x100;
+    words[999]= 0x8000000000000000ull;
+
+    assert(
+        (collect(jss::set_bit_indices(words)) ==
+         std::vector<size_t>{0, 3 * 64 + 1, 500 * 64 + 8, 999 * 64 + 63}));
+}
+
+void test_set_bit_indices_ignores_bits_past_the_end() {
+    uint32_t const words[]= {0xffffffffu, 0xffffffffu};
+
+    auto view= jss::set_bit_indices(words, 35);
+
+    std::vector<size_t> expected;
+    for(size_t i= 0; i < 35; ++i) {
+        expected.push_back(i);
+    }
+    assert(collect(view) == expected);
+    assert(view.size() == 35);
+}
+
+void test_set_bit_indices_of_small_words() {
+    std::array<uint8_t, 20> bytes{};
+    bytes[0]= 0x81;
+    bytes[19]= 0x02;
+
+    assert(
+        (collect(jss::set_bit_indices(bytes)) ==
+         std::vector<size_t>{0, 7, 19 * 8 + 1}));
+}
+
+void test_set_bit_indices_of_vector_bool() {
+    std::vector<bool> bits(1000);
+    std::vector<size_t> expected;
+    for(size_t i= 0; i < 990; i+= 37) {
+        bits[i]= true;
+        expected.push_back(i);
+    }
+    bits[999]= true;
+    expected.push_back(999);
+
+    auto view= jss::set_bit_indices(bits);
+
+    assert(collect(view) == expected);
+    assert(view.size() == expected.size());
+}
+
+void test_set_bit_indices_agrees_with_bit_by_bit_scan() {
+    std::vector<uint64_t> words(37);
+    uint64_t state= 12345;
+    for(auto &word : words) {
+        state= state * 6364136223846793005ull + 1442695040888963407ull;
+        word= state & (state >> 17) & (state >> 31);
+    }
+
+    std::vector<size_t> expected;
+    for(size_t i= 0; i < words.size() * 64; ++i) {
+        if((words[i / 64] >> (i % 64)) & 1)
+            expected.push_back(i);
+    }
+    assert(collect(jss::set_bit_indices(words)) == expected);
+    assert(jss::set_bit_indices(words).size() == expected.size());
+}
+
+void test_set_bit_indices_iterator_operations() {
+    uint64_t const word= 0x16;
+    auto view= jss::set_bit_indices(&word, 64);
+
+    auto it= view.begin();
+    assert(it->value == 1);
+    assert((*it++).value == 1);
+    auto it2= it;
+    assert(it2 == it);
+    assert(it2->index == 1);
+    assert(it2->value == 2);
+    ++it2;
+    assert(it2 != it);
+    assert(it2->value == 4);
+    ++it2;
+    assert(it2 == view.end());
+}
+
+std::vector<uint64_t> make_words() {
+    return std::vector<uint64_t>{0x3, 0, 0x8000000000000000ull};
+}
+
+std::vector<bool> make_bits() {
+    std::vector<bool> bits(200);
+    bits[1]= true;
+    bits[130]= true;
+    bits[199]= true;
+    return bits;
+}
+
+void test_set_bit_indices_of_temporaries_owns_the_bits() {
+    std::vector<size_t> positions;
+    for(auto x : jss::set_bit_indices(make_words())) {
+        positions.push_back(x.value);
+    }
+    assert((positions == std::vector<size_t>{0, 1, 191}));
+
+    auto view= jss::set_bit_indices(std::array<uint8_t, 3>{0x10, 0, 0x01});
+    assert((collect(view) == std::vector<size_t>{4, 16}));
+    assert(view.size() == 2);
+
+    positions.clear();
+    for(auto x : jss::set_bit_indices(make_bits())) {
+        positions.push_back(x.value);
+    }
+    assert((positions == std::vector<size_t>{1, 130, 199}));
+}
+
+void test_set_bit_indices_of_lvalues_refers_to_the_words() {
+    std::vector<uint64_t> words{1};
+    auto view= jss::set_bit_indices(words);
+    words[0]= 0x6;
+    assert((collect(view) == std::vector<size_t>{1, 2}));
+}
+
+int main() {
+    test_set_bit_indices_of_words();
+    test_set_bit_indices_of_empty_and_zero_words();
+    test_set_bit_indices_skips_long_runs_of_zero_words();
+    test_set_bit_indices_ignores_bits_past_the_end();
+    test_set_bit_indices_of_small_words();
+    test_set_bit_indices_of_vector_bool();
+    test_set_bit_indices_agrees_with_bit_by_bit_scan();
+    test_set_bit_indices_iterator_operations();
+    test_set_bit_indices_of_temporaries_owns_the_bits();
+    test_set_bit_indices_of_lvalues_refers_to_the_words();
+}
@@ -0,0 +1,162 @@
+#include "indexed_view_extrema.hpp"
+#include <assert.h>
+#include <algorithm>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/// A deterministic sequence of values with plenty of repeats
+template <typename T> std::vector<T> make_values(size_t count, unsigned seed) {
+    std::vector<T> values;
+    uint32_t state= seed;
+    for(size_t i= 0; i < count; ++i) {
+        state= state * 1664525u + 1013904223u;
+        values.push_back(static_cast<T>(static_cast<int>(state >> 24) - 100));
+    }
+    return values;
+}
+
+/// The indices of the top k values, computed by sorting
+template <typename T>
+std::vector<size_t> reference_top_k(std::vector<T> const &values, size_t k) {
+    std::vector<size_t> indices(values.size());
+    for(size_t i= 0; i < indices.size(); ++i) {
+        indices[i]= i;
+    }
+    std::stable_sort(indices.begin(), indices.end(), [&](size_t lhs, size_t rhs) {
+        return values[rhs] < values[lhs];
+    });
+    if(indices.size() > k)
+        indices.resize(k);
+    return indices;
+}
+
+template <typename T> void check_matches_reference(unsigned seed) {
+    size_t const sizes[]= {1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 100, 1001, 4099};
+    for(size_t size : sizes) {
+        auto values= make_values<T>(size, seed);
+        auto view= jss::indexed_view(values);
+        assert(
+            *jss::argmin(view) ==
+            static_cast<size_t>(
+                std::min_element(values.begin(), values.end()) -
+                values.begin()));
+        assert(
+            *jss::argmax(view) ==
+            static_cast<size_t>(
+                std::max_element(values.begin(), values.end()) -
+                values.begin()));
+        for(size_t k : {size_t(1), size_t(3), size_t(10), size + 1}) {
+            assert(jss::top_k_indices(view, k) == reference_top_k(values, k));
+        }
+    }
+}
+
+void test_argmin_argmax_and_top_k_match_reference_for_arithmetic_types() {
+    for(unsigned seed= 1; seed < 6; ++seed) {
+        check_matches_reference<int>(seed);
+        check_matches_reference<float>(seed);
+        check_matches_reference<double>(seed);
+        check_matches_reference<unsigned char>(seed);
+        check_matches_reference<long long>(seed);
+    }
+}
+
+void test_empty_views_give_no_index() {
+    std::vector<int> empty;
+    assert(!jss::argmin(jss::indexed_view(empty)));
+    assert(!jss::argmax(jss::indexed_view(empty)));
+    assert(jss::top_k_indices(jss::indexed_view(empty), 3).empty());
+
+    std::vector<int> v{1, 2, 3};
+    assert(jss::top_k_indices(jss::indexed_view(v), 0).empty());
+}
+
+void test_ties_give_first_index() {
+    std::vector<int> v(1000, 5);
+    v[700]= 1;
+    v[900]= 1;
+    v[300]= 8;
+    v[301]= 8;
+    assert(*jss::argmin(jss::indexed_view(v)) == 700);
+    assert(*jss::argmax(jss::indexed_view(v)) == 300);
+
+    std::vector<float> f(37, 2.5f);
+    assert(*jss::argmin(jss::indexed_view(f)) == 0);
+    assert(*jss::argmax(jss::indexed_view(f)) == 0);
+    assert(
+        jss::top_k_indices(jss::indexed_view(f), 3) ==
+        (std::vector<size_t>{0, 1, 2}));
+}
+
+void test_extrema_use_view_indices() {
+    std::vector<int> v{9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 1, 2, 3, 4, 5, 6};
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+    assert(*jss::argmin(second) == 9);
+    assert(*jss::argmax(second) == 15);
+    assert(
+        jss::top_k_indices(second, 2) == (std::vector<size_t>{15, 14}));
+
+    int const array[]= {4, 2, 8, 6};
+    assert(*jss::argmax(jss::indexed_view_n(array, 3)) == 2);
+    assert(*jss::argmin(jss::indexed_view(array)) == 1);
+
+    std::vector<float> const cv{1.5f, -2.5f, 0.5f};
+    assert(*jss::argmin(jss::indexed_view(cv)) == 1);
+}
+
+void test_extrema_of_non_contiguous_ranges() {
+    std::list<int> l{3, 1, 4, 1, 5, 9, 2, 6};
+    assert(*jss::argmin(jss::indexed_view(l)) == 1);
+    assert(*jss::argmax(jss::indexed_view(l)) == 5);
+    assert(
+        jss::top_k_indices(jss::indexed_view(l), 3) ==
+        (std::vector<size_t>{5, 7, 4}));
+
+    std::vector<std::string> words{"pear", "apple", "fig", "plum"};
+    assert(*jss::argmin(jss::indexed_view(words)) == 1);
+    assert(*jss::argmax(jss::indexed_view(words)) == 3);
+    assert(
+        jss::top_k_indices(jss::indexed_view(words), 2) ==
+        (std::vector<size_t>{3, 0}));
+}
+
+/// A value whose comparison fails for negative values
+struct fragile_value {
+    int value;
+
+    friend bool operator<(fragile_value lhs, fragile_value rhs) {
+        if(lhs.value < 0 || rhs.value < 0)
+            throw std::runtime_error("negative");
+        return lhs.value < rhs.value;
+    }
+};
+
+void test_extrema_let_exceptions_propagate_unchanged() {
+    std::vector<fragile_value> v(10, fragile_value{1});
+    v[4].value= -1;
+    unsigned caught= 0;
+    try {
+        jss::argmax(jss::indexed_view(v));
+    } catch(std::runtime_error const &) {
+        ++caught;
+    }
+    try {
+        jss::top_k_indices(jss::indexed_view(v), 2);
+    } catch(std::runtime_error const &) {
+        ++caught;
+    }
+    assert(caught == 2);
+}
+
+int main() {
+    test_argmin_argmax_and_top_k_match_reference_for_arithmetic_types();
+    test_empty_views_give_no_index();
+    test_ties_give_first_index();
+    test_extrema_use_view_indices();
+    test_extrema_of_non_contiguous_ranges();
+    test_extrema_let_exceptions_propagate_unchanged();
+}
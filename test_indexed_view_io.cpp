@@ -0,0 +1,265 @@
+#include "indexed_view_io.hpp"
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <system_error>
+#include <unistd.h>
+
+class temp_file {
+public:
+    explicit temp_file(std::string const &contents) {
+        char name[]= "/tmp/test_indexed_view_io_XXXXXX";
+        fd= mkstemp(name);
+        assert(fd != -1);
+        unlink(name);
+        size_t written= 0;
+        while(written < contents.size()) {
+            ssize_t const result= write(
+                fd, contents.data() + written, contents.size() - written);
+            assert(result > 0);
+            written+= static_cast<size_t>(result);
+        }
+        lseek(fd, 0, SEEK_SET);
+    }
+    ~temp_file() {
+        close(fd);
+    }
+
+    int fd;
+};
+
+template <typename Source>
+std::vector<std::pair<size_t, std::string>> collect(Source &source) {
+    std::vector<std::pair<size_t, std::string>> output;
+    for(auto x : jss::indexed_view(source)) {
+        output.push_back({x.index, std::string(x.value)});
+    }
+    return output;
+}
+
+void test_can_read_delimited_records_with_indices() {
+    temp_file file("hello\nworld\ngoodbye\n");
+    jss::fd_record_source source(file.fd, jss::record_format::delimited());
+
+    auto output= collect(source);
+    assert(output.size() == 3);
+    assert(output[0].first == 0);
+    assert(output[0].second == "hello");
+    assert(output[1].first == 1);
+    assert(output[1].second == "world");
+    assert(output[2].first == 2);
+    assert(output[2].second == "goodbye");
+}
+
+void test_final_unterminated_record_is_returned() {
+    temp_file file("a,bb,ccc");
+    jss::fd_record_source source(file.fd, jss::record_format::delimited(','));
+
+    auto output= collect(source);
+    assert(output.size() == 3);
+    assert(output[2].first == 2);
+    assert(output[2].second == "ccc");
+}
+
+void test_empty_records_are_preserved() {
+    temp_file file("\n\nx\n");
+    jss::fd_record_source source(file.fd, jss::record_format::delimited());
+
+    auto output= collect(source);
+    assert(output.size() == 3);
+    assert(output[0].second.empty());
+    assert(output[1].second.empty());
+    assert(output[2].second == "x");
+}
+
+void test_empty_file_has_no_records() {
+    temp_file file("");
+    jss::fd_record_source source(file.fd, jss::record_format::delimited());
+
+    assert(collect(source).empty());
+}
+
+void test_records_can_span_blocks() {
+    std::string contents;
+    std::vector<std::string> expected;
+    for(unsigned i= 0; i < 100; ++i) {
+        expected.push_back(std::string(i % 23, static_cast<char>('a' + i % 26)));
+        contents+= expected.back() + "\n";
+    }
+    expected.push_back(std::string(10000, 'z'));
+    contents+= expected.back() + "\n";
+    temp_file file(contents);
+    jss::fd_record_source source(file.fd, jss::record_format::delimited(), 7);
+
+    auto output= collect(source);
+    assert(output.size() == expected.size());
+    for(size_t i= 0; i < output.size(); ++i) {
+        assert(output[i].first == i);
+        assert(output[i].second == expected[i]);
+    }
+}
+
+void test_can_read_fixed_size_records() {
+    temp_file file("aaaabbbbccccdd");
+    jss::fd_record_source source(
+        file.fd, jss::record_format::fixed_size(4), 3);
+
+    auto output= collect(source);
+    assert(output.size() == 4);
+    assert(output[0].second == "aaaa");
+    assert(output[1].second == "bbbb");
+    assert(output[2].second == "cccc");
+    assert(output[3].first == 3);
+    assert(output[3].second == "dd");
+}
+
+void test_can_read_from_offset_with_pread() {
+    temp_file file("skip\none\ntwo\n");
+    jss::fd_record_source source(
+        file.fd, jss::record_format::delimited(),
+        jss::fd_record_source::default_block_size, 5);
+
+    auto output= collect(source);
+    assert(output.size() == 2);
+    assert(output[0].first == 0);
+    assert(output[0].second == "one");
+    assert(output[1].second == "two");
+    assert(lseek(file.fd, 0, SEEK_CUR) == 0);
+}
+
+void test_can_read_records_from_pipe() {
+    int fds[2];
+    assert(pipe(fds) == 0);
+    std::thread writer([&] {
+        for(unsigned i= 0; i < 1000; ++i) {
+            std::string const line= std::to_string(i) + "\n";
+            assert(write(fds[1], line.data(), line.size()) ==
+                   static_cast<ssize_t>(line.size()));
+        }
+        close(fds[1]);
+    });
+
+    jss::fd_record_source source(fds[0], jss::record_format::delimited(), 64);
+    size_t count= 0;
+    for(auto x : jss::indexed_view(source)) {
+        assert(x.index == count);
+        assert(x.value == std::to_string(count));
+        ++count;
+    }
+    assert(count == 1000);
+    writer.join();
+    close(fds[0]);
+}
+
+std::string numbered_lines(unsigned count, std::vector<std::string> &expected) {
+    std::string contents;
+    for(unsigned i= 0; i < count; ++i) {
+        expected.push_back(std::string(i % 37, static_cast<char>('a' + i % 26)));
+        contents+= expected.back() + "\n";
+    }
+    return contents;
+}
+
+void check_async_source_reads_all_records(jss::read_ahead_backend backend) {
+    std::vector<std::string> expected;
+    std::string contents= numbered_lines(500, expected);
+    expected.push_back(std::string(1000, 'z'));
+    contents+= expected.back();
+    temp_file file(contents);
+
+    jss::async_fd_record_source source(
+        file.fd, jss::record_format::delimited(), 64, 3, 0, backend);
+    if(backend == jss::read_ahead_backend::threads) {
+        assert(!source.uses_io_uring());
+    }
+
+    auto output= collect(source);
+    assert(output.size() == expected.size());
+    for(size_t i= 0; i < output.size(); ++i) {
+        assert(output[i].first == i);
+        assert(output[i].second == expected[i]);
+    }
+}
+
+void test_async_source_reads_records_in_order() {
+    check_async_source_reads_all_records(jss::read_ahead_backend::automatic);
+}
+
+void test_async_source_reads_records_with_thread_fallback() {
+    check_async_source_reads_all_records(jss::read_ahead_backend::threads);
+}
+
+void test_async_source_reads_records_with_io_uring_if_available() {
+    bool available= true;
+    try {
+        temp_file file("x");
+        jss::async_fd_record_source source(
+            file.fd, jss::record_format::delimited(),
+            jss::async_fd_record_source::default_block_size,
+            jss::async_fd_record_source::default_queue_depth, 0,
+            jss::read_ahead_backend::io_uring);
+        assert(source.uses_io_uring());
+    } catch(std::system_error const &) {
+        available= false;
+    }
+    if(available) {
+        check_async_source_reads_all_records(jss::read_ahead_backend::io_uring);
+    }
+}
+
+void test_async_source_reads_fixed_size_records_from_offset() {
+    std::string contents= "header";
+    for(unsigned i= 0; i < 1000; ++i) {
+        contents+= std::to_string(1000 + i);
+    }
+    temp_file file(contents);
+
+    jss::async_fd_record_source source(
+        file.fd, jss::record_format::fixed_size(4), 100, 2, 6);
+    size_t count= 0;
+    for(auto x : jss::indexed_view(source)) {
+        assert(x.index == count);
+        assert(x.value == std::to_string(1000 + count));
+        ++count;
+    }
+    assert(count == 1000);
+}
+
+void test_async_source_on_empty_file_has_no_records() {
+    temp_file file("");
+    jss::async_fd_record_source source(
+        file.fd, jss::record_format::delimited(), 64, 4);
+
+    assert(collect(source).empty());
+}
+
+void test_async_source_can_be_abandoned_with_reads_in_flight() {
+    std::vector<std::string> expected;
+    temp_file file(numbered_lines(1000, expected));
+    {
+        jss::async_fd_record_source source(
+            file.fd, jss::record_format::delimited(), 32, 8);
+        auto it= source.begin();
+        assert(*it == expected[0]);
+    }
+}
+
+int main() {
+    test_can_read_delimited_records_with_indices();
+    test_final_unterminated_record_is_returned();
+    test_empty_records_are_preserved();
+    test_empty_file_has_no_records();
+    test_records_can_span_blocks();
+    test_can_read_fixed_size_records();
+    test_can_read_from_offset_with_pread();
+    test_can_read_records_from_pipe();
+    test_async_source_reads_records_in_order();
+    test_async_source_reads_records_with_thread_fallback();
+    test_async_source_reads_records_with_io_uring_if_available();
+    test_async_source_reads_fixed_size_records_from_offset();
+    test_async_source_on_empty_file_has_no_records();
+    test_async_source_can_be_abandoned_with_reads_in_flight();
+}
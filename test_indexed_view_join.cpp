@@ -0,0 +1,150 @@
+#include "indexed_view_join.hpp"
+#include <assert.h>
+#include <array>
+#include <list>
+#include <string>
+#include <vector>
+
+struct join_entry {
+    size_t global_index;
+    size_t outer_index;
+    size_t inner_index;
+    int value;
+};
+
+void test_join_yields_global_outer_and_inner_indices() {
+    std::vector<std::vector<int>> shards{{1, 2}, {3}, {4, 5, 6}};
+
+    std::vector<join_entry> output;
+    for(auto x : jss::indexed_join(shards)) {
+        output.push_back(
+            {x.global_index, x.outer_index, x.inner_index, x.value});
+    }
+
+    assert(output.size() == 6);
+    size_t const expected_outer[]= {0, 0, 1, 2, 2, 2};
+    size_t const expected_inner[]= {0, 1, 0, 0, 1, 2};
+    for(size_t i= 0; i < output.size(); ++i) {
+        assert(output[i].global_index == i);
+        assert(output[i].outer_index == expected_outer[i]);
+        assert(output[i].inner_index == expected_inner[i]);
+        assert(output[i].value == static_cast<int>(i + 1));
+    }
+}
+
+void test_join_skips_empty_inner_ranges() {
+    std::vector<std::vector<int>> shards{{}, {}, {7}, {}, {8, 9}, {}};
+
+    std::vector<join_entry> output;
+    for(auto x : jss::indexed_join(shards)) {
+        output.push_back(
+            {x.global_index, x.outer_index, x.inner_index, x.value});
+    }
+
+    assert(output.size() == 3);
+    assert(output[0].global_index == 0);
+    assert(output[0].outer_index == 2);
+    assert(output[0].value == 7);
+    assert(output[1].global_index == 1);
+    assert(output[1].outer_index == 4);
+    assert(output[1].inner_index == 0);
+    assert(output[2].global_index == 2);
+    assert(output[2].outer_index == 4);
+    assert(output[2].inner_index == 1);
+}
+
+void test_join_of_empty_or_all_empty_ranges_is_empty() {
+    std::vector<std::vector<int>> none;
+    std::vector<std::vector<int>> empties(5);
+
+    auto view= jss::indexed_join(none);
+    assert(view.begin() == view.end());
+    auto view2= jss::indexed_join(empties);
+    assert(view2.begin() == view2.end());
+}
+
+void test_can_write_through_joined_view() {
+    std::vector<std::vector<size_t>> shards{
+        std::vector<size_t>(3), std::vector<size_t>(), std::vector<size_t>(4)};
+
+    for(auto x : jss::indexed_join(shards)) {
+        x.value= x.global_index * 10 + x.inner_index;
+    }
+
+    assert((shards[0] == std::vector<size_t>{0, 11, 22}));
+    assert((shards[2] == std::vector<size_t>{30, 41, 52, 63}));
+}
+
+void test_join_works_with_other_range_types() {
+    std::list<std::string> words{"ab", "", "cde"};
+    std::string letters;
+    size_t count= 0;
+    for(auto x : jss::indexed_join(words)) {
+        assert(x.global_index == count++);
+        letters+= x.value;
+    }
+    assert(letters == "abcde");
+
+    std::array<std::array<int, 2>, 3> const arrays{{{{1, 2}}, {{3, 4}}, {{5, 6}}}};
+    count= 0;
+    for(auto x : jss::indexed_join(arrays)) {
+        assert(x.global_index == count);
+        assert(x.outer_index == count / 2);
+        assert(x.inner_index == count % 2);
+        assert(x.value == static_cast<int>(count + 1));
+        ++count;
+    }
+    assert(count == 6);
+}
+
+void test_join_iterator_operations() {
+    std::vector<std::vector<int>> shards{{1, 2}, {3}};
+    auto view= jss::indexed_join(shards);
+
+    auto it= view.begin();
+    assert(it != view.end());
+    assert(it->global_index == 0);
+    assert((*it++).value == 1);
+    auto it2= it;
+    assert(it2 == it);
+    ++it2;
+    assert(it2 != it);
+    assert(it2->outer_index == 1);
+    ++it2;
+    assert(it2 == view.end());
+}
+
+void test_indexed_for_each_over_joined_view() {
+    std::vector<std::vector<int>> shards{{1, 2}, {}, {3}, {4, 5, 6}, {}};
+
+    std::vector<join_entry> output;
+    jss::indexed_for_each(jss::indexed_join(shards), [&](auto x) {
+        output.push_back(
+            {x.global_index, x.outer_index, x.inner_index, x.value});
+    });
+
+    assert(output.size() == 6);
+    size_t const expected_outer[]= {0, 0, 2, 3, 3, 3};
+    size_t const expected_inner[]= {0, 1, 0, 0, 1, 2};
+    for(size_t i= 0; i < output.size(); ++i) {
+        assert(output[i].global_index == i);
+        assert(output[i].outer_index == expected_outer[i]);
+        assert(output[i].inner_index == expected_inner[i]);
+        assert(output[i].value == static_cast<int>(i + 1));
+    }
+
+    long const sum= jss::indexed_accumulate(
+        jss::indexed_join(shards), 0L,
+        [](long total, auto x) { return total + x.value * static_cast<long>(x.global_index); });
+    assert(sum == 0 * 1 + 1 * 2 + 2 * 3 + 3 * 4 + 4 * 5 + 5 * 6);
+}
+
+int main() {
+    test_join_yields_global_outer_and_inner_indices();
+    test_join_skips_empty_inner_ranges();
+    test_join_of_empty_or_all_empty_ranges_is_empty();
+    test_can_write_through_joined_view();
+    test_join_works_with_other_range_types();
+    test_join_iterator_operations();
+    test_indexed_for_each_over_joined_view();
+}
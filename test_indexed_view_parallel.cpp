@@ -0,0 +1,1141 @@
+#include "indexed_view_parallel.hpp"
+#include <assert.h>
+#include <vector>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <new>
+#include <set>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+/// The value of allocations_until_failure when no failure is pending
+constexpr size_t no_allocation_failure= SIZE_MAX;
+
+/// The number of allocations on this thread that succeed before the next
+/// one throws std::bad_alloc
+thread_local size_t allocations_until_failure= no_allocation_failure;
+
+void *operator new(size_t size) {
+    if(allocations_until_failure != no_allocation_failure) {
+        if(!allocations_until_failure) {
+            allocations_until_failure= no_allocation_failure;
+            throw std::bad_alloc();
+        }
+        --allocations_until_failure;
+    }
+    if(void *p= malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void test_bulk_indexed_calls_func_with_global_index_for_each_element() {
+    jss::thread_pool pool(4);
+    std::vector<size_t> v(1000);
+
+    jss::sync_wait(jss::bulk_indexed(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { x.value= x.index + 1; }));
+
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == i + 1);
+    }
+}
+
+void test_bulk_indexed_runs_on_pool_threads() {
+    jss::thread_pool pool(3);
+    std::vector<int> v(100);
+    std::mutex m;
+    std::set<std::thread::id> ids;
+
+    jss::sync_wait(
+        jss::bulk_indexed(pool.get_scheduler(), jss::indexed_view(v), [&](auto) {
+            std::lock_guard<std::mutex> guard(m);
+            ids.insert(std::this_thread::get_id());
+        }));
+
+    assert(!ids.empty());
+    assert(ids.size() <= 3);
+    assert(!ids.count(std::this_thread::get_id()));
+}
+
+/// The addresses of inline_scheduler objects that have been destroyed
+std::set<void const *> destroyed_schedulers;
+
+/// A scheduler that runs all the work, and calls done(), on the calling
+/// thread before bulk_execute returns, and checks that it was not destroyed
+/// by done(), which would mean the caller used a scheduler owned by the
+/// operation
+class inline_scheduler {
+public:
+    inline_scheduler() {
+        destroyed_schedulers.erase(this);
+    }
+    inline_scheduler(inline_scheduler const &) {
+        destroyed_schedulers.erase(this);
+    }
+    inline_scheduler &operator=(inline_scheduler const &)= default;
+    ~inline_scheduler() {
+        destroyed_schedulers.insert(this);
+    }
+
+    template <typename ChunkFunc, typename Done>
+    void bulk_execute(size_t size, ChunkFunc chunk_func, Done done) const {
+        if(size)
+            chunk_func(0, size);
+        done();
+        assert(!destroyed_schedulers.count(this));
+    }
+};
+
+/// A receiver that destroys the operation that owns it on completion, as
+/// an operation allocated by an asynchronous caller would be
+class deleting_receiver {
+public:
+    deleting_receiver(std::shared_ptr<void> &owner_, bool &completed_) :
+        owner(&owner_), completed(&completed_) {}
+
+    void set_value() noexcept {
+        *completed= true;
+        owner->reset();
+    }
+    void set_error(std::exception_ptr) noexcept {
+        owner->reset();
+    }
+
+private:
+    std::shared_ptr<void> *owner;
+    bool *completed;
+};
+
+/// Start the sender with a receiver that destroys the operation on
+/// completion, and return true if it completed successfully
+template <typename Sender>
+bool start_self_destroying_operation(Sender &&sender) {
+    using operation_type= decltype(std::forward<Sender>(sender).connect(
+        std::declval<deleting_receiver>()));
+    std::shared_ptr<void> owner;
+    bool completed= false;
+    auto *const operation=
+        new operation_type(std::forward<Sender>(sender).connect(
+            deleting_receiver(owner, completed)));
+    owner.reset(operation);
+    operation->start();
+    assert(!owner);
+    return completed;
+}
+
+void test_bulk_indexed_operation_can_be_destroyed_on_completion() {
+    std::vector<size_t> v(100);
+    assert(start_self_destroying_operation(jss::bulk_indexed(
+        inline_scheduler(), jss::indexed_view(v),
+        [](auto x) { x.value= x.index; })));
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == i);
+    }
+}
+
+void test_bulk_indexed_preserves_indices_of_split_views() {
+    jss::thread_pool pool(2);
+    std::vector<size_t> v(100);
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+
+    jss::sync_wait(jss::bulk_indexed(
+        pool.get_scheduler(), second, [](auto x) { x.value= x.index; }));
+
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == (i < 50 ? 0 : i));
+    }
+}
+
+void test_bulk_indexed_on_empty_view_completes() {
+    jss::thread_pool pool(2);
+    std::vector<int> v;
+    unsigned calls= 0;
+
+    jss::sync_wait(jss::bulk_indexed(
+        pool.get_scheduler(), jss::indexed_view(v), [&](auto) { ++calls; }));
+
+    assert(calls == 0);
+}
+
+void test_bulk_indexed_processes_non_random_access_views_in_order() {
+    jss::thread_pool pool(2);
+    std::list<size_t> l(20);
+    std::vector<size_t> order;
+
+    jss::sync_wait(jss::bulk_indexed(
+        pool.get_scheduler(), jss::indexed_view(l), [&](auto x) {
+            x.value= x.index;
+            order.push_back(x.index);
+        }));
+
+    assert(order.size() == l.size());
+    size_t i= 0;
+    for(auto x : l) {
+        assert(x == i);
+        assert(order[i] == i);
+        ++i;
+    }
+}
+
+void test_bulk_indexed_propagates_exceptions() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(1000);
+
+    bool caught= false;
+    try {
+        jss::sync_wait(jss::bulk_indexed(
+            pool.get_scheduler(), jss::indexed_view(v), [](auto x) {
+                if(x.index == 567)
+                    throw std::runtime_error("567");
+            }));
+    } catch(jss::indexed_exception const &e) {
+        assert(e.index() == 567);
+        try {
+            e.rethrow_nested();
+        } catch(std::runtime_error const &nested) {
+            caught= true;
+            assert(std::string(nested.what()) == "567");
+        }
+    }
+    assert(caught);
+}
+
+struct flag_receiver {
+    std::atomic<int> *state;
+
+    void set_value() noexcept {
+        state->store(1);
+    }
+    void set_error(std::exception_ptr) noexcept {
+        state->store(2);
+    }
+};
+
+void test_bulk_indexed_sender_can_be_connected_to_custom_receiver() {
+    std::atomic<int> state(0);
+    std::vector<int> v(50);
+    jss::thread_pool pool(2);
+    auto sender= jss::bulk_indexed(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { x.value= static_cast<int>(x.index); });
+    auto operation= sender.connect(flag_receiver{&state});
+    assert(state == 0);
+    operation.start();
+    while(!state) {
+        std::this_thread::yield();
+    }
+    assert(state == 1);
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == static_cast<int>(i));
+    }
+}
+
+struct counting_receiver {
+    std::atomic<int> *values;
+    std::atomic<int> *errors;
+
+    void set_value() noexcept {
+        ++*values;
+    }
+    void set_error(std::exception_ptr e) noexcept {
+        try {
+            std::rethrow_exception(e);
+        } catch(std::bad_alloc const &) {
+        }
+        ++*errors;
+    }
+};
+
+void test_bulk_indexed_completes_once_if_submission_fails() {
+    bool failed_after_submitting= false;
+    for(size_t allocations= 0;; ++allocations) {
+        std::atomic<int> values(0);
+        std::atomic<int> errors(0);
+        std::vector<int> v(1000);
+        auto pool= std::make_unique<jss::thread_pool>(4);
+        auto operation=
+            jss::bulk_indexed(
+                pool->get_scheduler(), jss::indexed_view(v),
+                [](auto x) { x.value= 1; })
+                .connect(counting_receiver{&values, &errors});
+        allocations_until_failure= allocations;
+        operation.start();
+        bool const failed=
+            allocations_until_failure == no_allocation_failure;
+        allocations_until_failure= no_allocation_failure;
+        pool.reset();
+        assert(values + errors == 1);
+        if(!failed)
+            break;
+        if(values) {
+            failed_after_submitting= true;
+            for(auto x : v) {
+                assert(x == 1);
+            }
+        }
+    }
+    assert(failed_after_submitting);
+}
+
+void test_bulk_indexed_buckets_snapshots_unordered_map_with_dense_indices() {
+    jss::thread_pool pool(4);
+    std::unordered_map<int, int> m;
+    for(int i= 0; i < 10000; ++i) {
+        m[i]= i * 3;
+    }
+    std::vector<std::pair<int, int>> snapshot(m.size(), std::make_pair(-1, -1));
+
+    jss::sync_wait(
+        jss::bulk_indexed_buckets(pool.get_scheduler(), m, [&](auto x) {
+            snapshot[x.index]= x.value;
+        }));
+
+    std::vector<bool> seen(m.size());
+    for(auto const &entry : snapshot) {
+        assert(entry.first >= 0);
+        assert(entry.second == entry.first * 3);
+        assert(!seen[entry.first]);
+        seen[entry.first]= true;
+    }
+}
+
+void test_bulk_indexed_buckets_numbers_buckets_in_order() {
+    jss::thread_pool pool(3);
+    std::unordered_multiset<int> s;
+    for(int i= 0; i < 5000; ++i) {
+        s.insert(i % 1000);
+    }
+    std::vector<int> snapshot(s.size());
+
+    jss::sync_wait(jss::bulk_indexed_buckets(
+        pool.get_scheduler(), s,
+        [&](auto x) { snapshot[x.index]= x.value; }));
+
+    size_t index= 0;
+    for(size_t b= 0; b < s.bucket_count(); ++b) {
+        for(auto it= s.begin(b); it != s.end(b); ++it) {
+            assert(snapshot[index++] == *it);
+        }
+    }
+    assert(index == s.size());
+}
+
+void test_bulk_indexed_buckets_can_modify_mapped_values() {
+    jss::thread_pool pool(2);
+    std::unordered_map<std::string, size_t> m;
+    for(unsigned i= 0; i < 300; ++i) {
+        m[std::to_string(i)]= 0;
+    }
+    std::vector<unsigned> counts(m.size());
+
+    jss::sync_wait(
+        jss::bulk_indexed_buckets(pool.get_scheduler(), m, [&](auto x) {
+            x.value.second= x.index;
+            ++counts[x.index];
+        }));
+
+    for(auto count : counts) {
+        assert(count == 1);
+    }
+    std::vector<bool> seen(m.size());
+    for(auto const &entry : m) {
+        assert(!seen[entry.second]);
+        seen[entry.second]= true;
+    }
+}
+
+void test_bulk_indexed_buckets_on_empty_container_completes() {
+    jss::thread_pool pool(2);
+    std::unordered_set<int> s;
+    unsigned calls= 0;
+
+    jss::sync_wait(jss::bulk_indexed_buckets(
+        pool.get_scheduler(), s, [&](auto) { ++calls; }));
+
+    assert(calls == 0);
+}
+
+void test_bulk_indexed_buckets_operation_can_be_destroyed_on_completion() {
+    std::unordered_map<int, int> m;
+    for(int i= 0; i < 100; ++i) {
+        m[i]= 0;
+    }
+    std::vector<unsigned> seen(m.size());
+    assert(start_self_destroying_operation(jss::bulk_indexed_buckets(
+        inline_scheduler(), m, [&](auto x) {
+            ++seen[x.index];
+            ++x.value.second;
+        })));
+    for(auto count : seen) {
+        assert(count == 1);
+    }
+    for(auto const &entry : m) {
+        assert(entry.second == 1);
+    }
+}
+
+void test_bulk_indexed_buckets_propagates_exceptions() {
+    jss::thread_pool pool(4);
+    std::unordered_set<int> s;
+    for(int i= 0; i < 1000; ++i) {
+        s.insert(i);
+    }
+
+    std::vector<int> snapshot(s.size());
+
+    bool caught= false;
+    try {
+        jss::sync_wait(
+            jss::bulk_indexed_buckets(pool.get_scheduler(), s, [&](auto x) {
+                snapshot[x.index]= x.value;
+                if(x.value == 567)
+                    throw std::runtime_error("567");
+            }));
+    } catch(jss::indexed_exception const &e) {
+        assert(snapshot[e.index()] == 567);
+        try {
+            e.rethrow_nested();
+        } catch(std::runtime_error const &nested) {
+            caught= true;
+            assert(std::string(nested.what()) == "567");
+        }
+    }
+    assert(caught);
+}
+
+void test_bulk_indexed_exception_cancels_remaining_elements() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(1 << 20);
+    std::atomic<size_t> processed(0);
+    jss::cancellation_token token;
+
+    bool caught= false;
+    try {
+        jss::sync_wait(jss::bulk_indexed(
+            pool.get_scheduler(), jss::indexed_view(v),
+            [&](auto x) {
+                processed.fetch_add(1, std::memory_order_relaxed);
+                if(x.index == 10)
+                    throw std::runtime_error("10");
+            },
+            token));
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 10);
+    }
+    assert(caught);
+    assert(token.is_cancelled());
+    assert(processed.load() < v.size());
+}
+
+void test_bulk_indexed_stops_when_token_is_cancelled() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(1 << 20);
+    std::atomic<size_t> processed(0);
+    jss::cancellation_token token;
+
+    bool caught= false;
+    try {
+        jss::sync_wait(jss::bulk_indexed(
+            pool.get_scheduler(), jss::indexed_view(v),
+            [&](auto x) {
+                processed.fetch_add(1, std::memory_order_relaxed);
+                if(x.index == 100)
+                    token.cancel();
+            },
+            token));
+    } catch(jss::operation_cancelled const &) {
+        caught= true;
+    }
+    assert(caught);
+    assert(processed.load() < v.size());
+}
+
+void test_bulk_indexed_with_cancelled_token_processes_nothing() {
+    jss::thread_pool pool(2);
+    std::vector<int> v(100);
+    std::list<int> l(100);
+    jss::cancellation_token token;
+    token.cancel();
+    std::atomic<unsigned> calls(0);
+
+    for(int pass= 0; pass < 2; ++pass) {
+        bool caught= false;
+        try {
+            auto count_calls= [&](auto) { ++calls; };
+            if(pass)
+                jss::sync_wait(jss::bulk_indexed(
+                    pool.get_scheduler(), jss::indexed_view(l), count_calls,
+                    token));
+            else
+                jss::sync_wait(jss::bulk_indexed(
+                    pool.get_scheduler(), jss::indexed_view(v), count_calls,
+                    token));
+        } catch(jss::operation_cancelled const &) {
+            caught= true;
+        }
+        assert(caught);
+    }
+    assert(calls == 0);
+}
+
+void test_bulk_indexed_with_token_completes_normally_if_not_cancelled() {
+    jss::thread_pool pool(3);
+    std::vector<size_t> v(5000);
+    jss::cancellation_token token;
+
+    jss::sync_wait(jss::bulk_indexed(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { x.value= x.index; }, token));
+
+    assert(!token.is_cancelled());
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == i);
+    }
+}
+
+void test_bulk_indexed_buckets_stops_when_token_is_cancelled() {
+    jss::thread_pool pool(2);
+    std::unordered_set<int> s;
+    for(int i= 0; i < 100000; ++i) {
+        s.insert(i);
+    }
+    std::atomic<size_t> processed(0);
+    jss::cancellation_token token;
+
+    bool caught= false;
+    try {
+        jss::sync_wait(jss::bulk_indexed_buckets(
+            pool.get_scheduler(), s,
+            [&](auto) {
+                if(processed.fetch_add(1) == 10)
+                    token.cancel();
+            },
+            token));
+    } catch(jss::operation_cancelled const &) {
+        caught= true;
+    }
+    assert(caught);
+    assert(processed.load() < s.size());
+}
+
+void test_sequential_loop_can_poll_cancellation_token() {
+    std::vector<int> v(100);
+    jss::cancellation_token token;
+    size_t last= 0;
+    for(auto x : jss::indexed_view(v)) {
+        if(token.is_cancelled())
+            break;
+        last= x.index;
+        if(x.index == 42)
+            token.cancel();
+    }
+    assert(last == 42);
+
+    bool caught= false;
+    try {
+        token.throw_if_cancelled();
+    } catch(jss::operation_cancelled const &) {
+        caught= true;
+    }
+    assert(caught);
+}
+
+void test_find_first_index_finds_lowest_matching_index() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(100000);
+    v[77777]= 1;
+    v[12345]= 1;
+    v[99999]= 1;
+
+    auto found= jss::find_first_index(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { return x.value == 1; });
+    assert(found);
+    assert(*found == 12345);
+}
+
+void test_find_first_index_returns_nullopt_if_no_match() {
+    jss::thread_pool pool(3);
+    std::vector<int> v(5000, 2);
+    std::vector<int> empty;
+
+    assert(!jss::find_first_index(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { return x.value == 1; }));
+    assert(!jss::find_first_index(
+        pool.get_scheduler(), jss::indexed_view(empty),
+        [](auto) { return true; }));
+}
+
+void test_find_first_index_stops_early() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(1 << 22);
+    v[5]= 1;
+    std::atomic<size_t> calls(0);
+
+    auto found= jss::find_first_index(
+        pool.get_scheduler(), jss::indexed_view(v), [&](auto x) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            return x.value == 1;
+        });
+    assert(found);
+    assert(*found == 5);
+    assert(calls.load() < v.size() / 2);
+}
+
+void test_find_first_index_uses_indices_of_split_and_sequential_views() {
+    jss::thread_pool pool(2);
+    std::vector<int> v{0, 1, 0, 1, 0, 1, 0, 1};
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+    auto found= jss::find_first_index(
+        pool.get_scheduler(), second, [](auto x) { return x.value == 1; });
+    assert(found);
+    assert(*found == 5);
+
+    std::list<int> l{4, 5, 6, 5};
+    found= jss::find_first_index(
+        pool.get_scheduler(), jss::indexed_view(l),
+        [](auto x) { return x.value == 5; });
+    assert(found);
+    assert(*found == 1);
+}
+
+void test_find_first_index_propagates_exceptions_with_index() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(10000);
+
+    bool caught= false;
+    try {
+        jss::find_first_index(
+            pool.get_scheduler(), jss::indexed_view(v), [](auto x) {
+                if(x.index == 4321)
+                    throw std::runtime_error("4321");
+                return false;
+            });
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 4321);
+    }
+    assert(caught);
+}
+
+void test_indexed_inclusive_scan_computes_running_totals() {
+    jss::thread_pool pool(4);
+    std::vector<unsigned> lengths(100000);
+    for(size_t i= 0; i < lengths.size(); ++i) {
+        lengths[i]= static_cast<unsigned>(i % 13 + 1);
+    }
+    std::vector<jss::indexed_scan_result<size_t>> offsets(lengths.size());
+
+    auto end= jss::indexed_inclusive_scan(
+        pool.get_scheduler(), jss::indexed_view(lengths), offsets.begin(),
+        size_t(0));
+    assert(end == offsets.end());
+
+    size_t total= 0;
+    for(size_t i= 0; i < lengths.size(); ++i) {
+        total+= lengths[i];
+        assert(offsets[i].index == i);
+        assert(offsets[i].value == total);
+    }
+}
+
+void test_indexed_exclusive_scan_starts_from_init() {
+    jss::thread_pool pool(3);
+    std::vector<int> lengths(50000, 2);
+    std::vector<jss::indexed_scan_result<long>> offsets(lengths.size());
+
+    jss::indexed_exclusive_scan(
+        pool.get_scheduler(), jss::indexed_view(lengths), offsets.begin(),
+        100L);
+
+    for(size_t i= 0; i < lengths.size(); ++i) {
+        assert(offsets[i].index == i);
+        assert(offsets[i].value == static_cast<long>(100 + 2 * i));
+    }
+}
+
+void test_indexed_scan_of_small_and_empty_views() {
+    jss::thread_pool pool(2);
+    std::vector<int> v{3, 1, 4, 1, 5};
+    std::vector<jss::indexed_scan_result<int>> out(v.size());
+
+    jss::indexed_inclusive_scan(
+        pool.get_scheduler(), jss::indexed_view(v), out.begin(), 0);
+    int const inclusive[]= {3, 4, 8, 9, 14};
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(out[i].index == i);
+        assert(out[i].value == inclusive[i]);
+    }
+
+    jss::indexed_exclusive_scan(
+        pool.get_scheduler(), jss::indexed_view(v), out.begin(), 0);
+    int const exclusive[]= {0, 3, 4, 8, 9};
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(out[i].value == exclusive[i]);
+    }
+
+    std::vector<int> empty;
+    assert(
+        jss::indexed_inclusive_scan(
+            pool.get_scheduler(), jss::indexed_view(empty), out.begin(), 0) ==
+        out.begin());
+}
+
+/// An affine map x -> a*x+b modulo 2^32. Composing maps is associative but
+/// not commutative, so scans must combine them in order
+struct affine_map {
+    uint32_t a;
+    uint32_t b;
+
+    friend bool operator==(affine_map const &lhs, affine_map const &rhs) {
+        return lhs.a == rhs.a && lhs.b == rhs.b;
+    }
+};
+
+/// Apply first, then second
+affine_map compose(affine_map const &first, affine_map const &second) {
+    return affine_map{second.a * first.a, second.a * first.b + second.b};
+}
+
+void test_indexed_scan_uses_op_in_order_and_keeps_view_indices() {
+    jss::thread_pool pool(4);
+    std::vector<affine_map> maps(80000);
+    for(size_t i= 0; i < maps.size(); ++i) {
+        maps[i]= affine_map{
+            static_cast<uint32_t>(i * 2 + 1), static_cast<uint32_t>(i % 7)};
+    }
+    auto view= jss::indexed_view(maps);
+    decltype(view) second(view, jss::split());
+    std::vector<jss::indexed_scan_result<affine_map>> out(second.size());
+    affine_map const identity{1, 0};
+
+    jss::indexed_inclusive_scan(
+        pool.get_scheduler(), second, out.begin(), identity, compose);
+
+    affine_map expected= identity;
+    for(size_t i= 0; i < out.size(); ++i) {
+        expected= compose(expected, maps[i + 40000]);
+        assert(out[i].index == i + 40000);
+        assert(out[i].value == expected);
+    }
+}
+
+void test_indexed_scan_propagates_exceptions_with_index() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(100000, 1);
+    std::vector<jss::indexed_scan_result<int>> out(v.size());
+
+    bool caught= false;
+    try {
+        jss::indexed_inclusive_scan(
+            pool.get_scheduler(), jss::indexed_view(v), out.begin(), 0,
+            [](int total, int value) {
+                if(total == 54321)
+                    throw std::runtime_error("overflow");
+                return total + value;
+            });
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 54321);
+    }
+    assert(caught);
+}
+
+void test_indexed_reduce_sums_values() {
+    jss::thread_pool pool(4);
+    std::vector<unsigned> v(100000);
+    for(size_t i= 0; i < v.size(); ++i) {
+        v[i]= static_cast<unsigned>(i % 17);
+    }
+    size_t expected= 0;
+    for(auto x : v) {
+        expected+= x;
+    }
+
+    assert(
+        jss::indexed_reduce(
+            pool.get_scheduler(), jss::indexed_view(v), size_t(5)) ==
+        expected + 5);
+}
+
+void test_indexed_reduce_is_identical_for_any_thread_count() {
+    std::vector<double> v(300001);
+    for(size_t i= 0; i < v.size(); ++i) {
+        v[i]= 1.0 / static_cast<double>(i + 1) * ((i % 3) ? 1e8 : -1e-8);
+    }
+
+    double reference= 0;
+    for(unsigned threads= 1; threads <= 8; ++threads) {
+        jss::thread_pool pool(threads);
+        double const sum= jss::indexed_reduce(
+            pool.get_scheduler(), jss::indexed_view(v), 0.0);
+        if(threads == 1)
+            reference= sum;
+        assert(memcmp(&sum, &reference, sizeof(double)) == 0);
+    }
+}
+
+void test_indexed_reduce_combines_in_index_order() {
+    jss::thread_pool pool(3);
+    std::vector<affine_map> maps(50000);
+    for(size_t i= 0; i < maps.size(); ++i) {
+        maps[i]= affine_map{
+            static_cast<uint32_t>(i * 6 + 1), static_cast<uint32_t>(i % 11)};
+    }
+    affine_map const start{3, 4};
+
+    affine_map expected= start;
+    for(auto const &map : maps) {
+        expected= compose(expected, map);
+    }
+    assert(
+        jss::indexed_reduce(
+            pool.get_scheduler(), jss::indexed_view(maps), start, compose) ==
+        expected);
+}
+
+void test_indexed_reduce_of_empty_and_sequential_views() {
+    jss::thread_pool pool(2);
+    std::vector<int> empty;
+    assert(
+        jss::indexed_reduce(pool.get_scheduler(), jss::indexed_view(empty), 7) ==
+        7);
+
+    std::list<int> l{1, 2, 3, 4};
+    assert(
+        jss::indexed_reduce(
+            pool.get_scheduler(), jss::indexed_view(l), 1,
+            [](int lhs, int rhs) { return lhs * rhs; }) == 24);
+}
+
+void test_indexed_reduce_propagates_exceptions_with_index() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(20000, 1);
+    v[12345]= -1;
+
+    bool caught= false;
+    try {
+        jss::indexed_reduce(
+            pool.get_scheduler(), jss::indexed_view(v), 0,
+            [](int total, int value) {
+                if(value < 0)
+                    throw std::runtime_error("negative");
+                return total + value;
+            });
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 12345);
+    }
+    assert(caught);
+}
+
+void test_parallel_extrema_match_sequential_extrema() {
+    jss::thread_pool pool(4);
+    std::vector<float> v(300000);
+    uint32_t state= 42;
+    for(auto &x : v) {
+        state= state * 1664525u + 1013904223u;
+        x= static_cast<float>(state >> 8) / 65536.0f;
+    }
+    auto view= jss::indexed_view(v);
+    assert(jss::argmin(pool.get_scheduler(), view) == jss::argmin(view));
+    assert(jss::argmax(pool.get_scheduler(), view) == jss::argmax(view));
+    assert(
+        jss::top_k_indices(pool.get_scheduler(), view, 25) ==
+        jss::top_k_indices(view, 25));
+}
+
+void test_parallel_extrema_give_first_index_across_blocks() {
+    jss::thread_pool pool(3);
+    std::vector<int> v(200000, 5);
+    v[150000]= 1;
+    v[70000]= 1;
+    v[199999]= 9;
+    v[100]= 9;
+    assert(*jss::argmin(pool.get_scheduler(), jss::indexed_view(v)) == 70000);
+    assert(*jss::argmax(pool.get_scheduler(), jss::indexed_view(v)) == 100);
+    assert(
+        jss::top_k_indices(pool.get_scheduler(), jss::indexed_view(v), 4) ==
+        (std::vector<size_t>{100, 199999, 0, 1}));
+}
+
+void test_parallel_extrema_of_split_and_sequential_views() {
+    jss::thread_pool pool(2);
+    std::vector<int> v(150000);
+    for(size_t i= 0; i < v.size(); ++i) {
+        v[i]= static_cast<int>(i % 1000);
+    }
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+    assert(*jss::argmin(pool.get_scheduler(), second) == 75000);
+    assert(*jss::argmax(pool.get_scheduler(), second) == 75999);
+    assert(
+        jss::top_k_indices(pool.get_scheduler(), second, 2) ==
+        jss::top_k_indices(second, 2));
+
+    std::vector<int> empty;
+    assert(!jss::argmin(pool.get_scheduler(), jss::indexed_view(empty)));
+
+    std::list<int> l{3, 1, 4, 1, 5, 9, 2, 6};
+    assert(*jss::argmin(pool.get_scheduler(), jss::indexed_view(l)) == 1);
+    assert(*jss::argmax(pool.get_scheduler(), jss::indexed_view(l)) == 5);
+    assert(
+        jss::top_k_indices(pool.get_scheduler(), jss::indexed_view(l), 2) ==
+        (std::vector<size_t>{5, 7}));
+}
+
+/// A value whose comparison fails for negative values
+struct fragile_value {
+    int value;
+
+    friend bool operator<(fragile_value lhs, fragile_value rhs) {
+        if(lhs.value < 0 || rhs.value < 0)
+            throw std::runtime_error("negative");
+        return lhs.value < rhs.value;
+    }
+};
+
+void test_parallel_extrema_propagate_exceptions_with_index() {
+    jss::thread_pool pool(4);
+    std::vector<fragile_value> v(200000, fragile_value{1});
+    v[140000].value= -1;
+
+    bool caught= false;
+    try {
+        jss::argmax(pool.get_scheduler(), jss::indexed_view(v));
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 140000);
+    }
+    assert(caught);
+
+    caught= false;
+    try {
+        jss::top_k_indices(pool.get_scheduler(), jss::indexed_view(v), 3);
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 140000);
+    }
+    assert(caught);
+}
+
+void test_parallel_extrema_of_small_and_sequential_views_wrap_exceptions() {
+    jss::thread_pool pool(2);
+    std::vector<fragile_value> v(100, fragile_value{1});
+    v[42].value= -1;
+    std::list<fragile_value> l(v.begin(), v.end());
+
+    unsigned caught= 0;
+    try {
+        jss::argmin(pool.get_scheduler(), jss::indexed_view(v));
+    } catch(jss::indexed_exception const &e) {
+        ++caught;
+        assert(e.index() == 42);
+    }
+    try {
+        jss::argmin(pool.get_scheduler(), jss::indexed_view(l));
+    } catch(jss::indexed_exception const &e) {
+        ++caught;
+        assert(e.index() == 42);
+    }
+    try {
+        jss::top_k_indices(pool.get_scheduler(), jss::indexed_view(v), 2);
+    } catch(jss::indexed_exception const &e) {
+        ++caught;
+        assert(e.index() == 42);
+    }
+    try {
+        jss::top_k_indices(pool.get_scheduler(), jss::indexed_view(l), 2);
+    } catch(jss::indexed_exception const &e) {
+        ++caught;
+        assert(e.index() == 42);
+        try {
+            std::rethrow_if_nested(e);
+        } catch(std::runtime_error const &) {
+            ++caught;
+        }
+    }
+    assert(caught == 5);
+}
+
+void test_parallel_indices_where_matches_sequential_indices_where() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(300000);
+    uint32_t state= 7;
+    for(auto &x : v) {
+        state= state * 1664525u + 1013904223u;
+        x= static_cast<int>(state >> 24);
+    }
+    for(int threshold : {0, 3, 128, 256}) {
+        auto const pred= [threshold](auto x) { return x.value < threshold; };
+        std::vector<size_t> expected(
+            jss::count_where(jss::indexed_view(v), pred));
+        jss::indices_where(jss::indexed_view(v), pred, expected.data());
+
+        std::vector<size_t> indices(expected.size() + 1, 42);
+        size_t *const end= jss::indices_where(
+            pool.get_scheduler(), jss::indexed_view(v), pred, indices.data());
+        assert(end == indices.data() + expected.size());
+        assert(indices.back() == 42);
+        indices.pop_back();
+        assert(indices == expected);
+    }
+
+    std::vector<size_t> odd(v.size() / 2);
+    auto const odd_end= jss::indices_where(
+        pool.get_scheduler(), jss::indexed_view(v),
+        [](auto x) { return x.index % 2 == 1; }, odd.begin());
+    assert(odd_end == odd.end());
+    for(size_t i= 0; i < odd.size(); ++i) {
+        assert(odd[i] == 2 * i + 1);
+    }
+}
+
+void test_parallel_indices_where_of_split_and_sequential_views() {
+    jss::thread_pool pool(2);
+    std::vector<int> v(200000);
+    for(size_t i= 0; i < v.size(); ++i) {
+        v[i]= static_cast<int>(i % 1000);
+    }
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+    std::vector<size_t> zeros(100);
+    auto const end= jss::indices_where(
+        pool.get_scheduler(), second, [](auto x) { return x.value == 0; },
+        zeros.data());
+    assert(end == zeros.data() + 100);
+    for(size_t i= 0; i < zeros.size(); ++i) {
+        assert(zeros[i] == 100000 + i * 1000);
+    }
+
+    std::list<int> l{3, -1, 4, -1, 5, -9};
+    std::vector<size_t> negatives(3);
+    jss::indices_where(
+        pool.get_scheduler(), jss::indexed_view(l),
+        [](auto x) { return x.value < 0; }, negatives.begin());
+    assert(negatives == (std::vector<size_t>{1, 3, 5}));
+}
+
+void test_parallel_indices_where_propagates_exceptions_with_index() {
+    jss::thread_pool pool(4);
+    std::vector<int> v(200000, 1);
+    v[140000]= -1;
+    std::vector<size_t> indices(v.size());
+
+    bool caught= false;
+    try {
+        jss::indices_where(
+            pool.get_scheduler(), jss::indexed_view(v),
+            [](auto x) {
+                if(x.value < 0)
+                    throw std::runtime_error("negative");
+                return x.value > 1;
+            },
+            indices.data());
+    } catch(jss::indexed_exception const &e) {
+        caught= true;
+        assert(e.index() == 140000);
+    }
+    assert(caught);
+
+    std::vector<int> small(100, 1);
+    small[42]= -1;
+    std::list<int> l(small.begin(), small.end());
+    unsigned small_caught= 0;
+    try {
+        jss::indices_where(
+            pool.get_scheduler(), jss::indexed_view(small),
+            [](auto x) {
+                if(x.value < 0)
+                    throw std::runtime_error("negative");
+                return false;
+            },
+            indices.data());
+    } catch(jss::indexed_exception const &e) {
+        ++small_caught;
+        assert(e.index() == 42);
+    }
+    try {
+        jss::indices_where(
+            pool.get_scheduler(), jss::indexed_view(l),
+            [](auto x) {
+                if(x.value < 0)
+                    throw std::runtime_error("negative");
+                return false;
+            },
+            indices.data());
+    } catch(jss::indexed_exception const &e) {
+        ++small_caught;
+        assert(e.index() == 42);
+    }
+    assert(small_caught == 2);
+}
+
+int main() {
+    test_bulk_indexed_calls_func_with_global_index_for_each_element();
+    test_bulk_indexed_runs_on_pool_threads();
+    test_bulk_indexed_preserves_indices_of_split_views();
+    test_bulk_indexed_operation_can_be_destroyed_on_completion();
+    test_bulk_indexed_on_empty_view_completes();
+    test_bulk_indexed_processes_non_random_access_views_in_order();
+    test_bulk_indexed_propagates_exceptions();
+    test_bulk_indexed_sender_can_be_connected_to_custom_receiver();
+    test_bulk_indexed_completes_once_if_submission_fails();
+    test_bulk_indexed_buckets_snapshots_unordered_map_with_dense_indices();
+    test_bulk_indexed_buckets_numbers_buckets_in_order();
+    test_bulk_indexed_buckets_can_modify_mapped_values();
+    test_bulk_indexed_buckets_on_empty_container_completes();
+    test_bulk_indexed_buckets_operation_can_be_destroyed_on_completion();
+    test_bulk_indexed_buckets_propagates_exceptions();
+    test_bulk_indexed_exception_cancels_remaining_elements();
+    test_bulk_indexed_stops_when_token_is_cancelled();
+    test_bulk_indexed_with_cancelled_token_processes_nothing();
+    test_bulk_indexed_with_token_completes_normally_if_not_cancelled();
+    test_bulk_indexed_buckets_stops_when_token_is_cancelled();
+    test_sequential_loop_can_poll_cancellation_token();
+    test_find_first_index_finds_lowest_matching_index();
+    test_find_first_index_returns_nullopt_if_no_match();
+    test_find_first_index_stops_early();
+    test_find_first_index_uses_indices_of_split_and_sequential_views();
+    test_find_first_index_propagates_exceptions_with_index();
+    test_indexed_inclusive_scan_computes_running_totals();
+    test_indexed_exclusive_scan_starts_from_init();
+    test_indexed_scan_of_small_and_empty_views();
+    test_indexed_scan_uses_op_in_order_and_keeps_view_indices();
+    test_indexed_scan_propagates_exceptions_with_index();
+    test_indexed_reduce_sums_values();
+    test_indexed_reduce_is_identical_for_any_thread_count();
+    test_indexed_reduce_combines_in_index_order();
+    test_indexed_reduce_of_empty_and_sequential_views();
+    test_indexed_reduce_propagates_exceptions_with_index();
+    test_parallel_extrema_match_sequential_extrema();
+    test_parallel_extrema_give_first_index_across_blocks();
+    test_parallel_extrema_of_split_and_sequential_views();
+    test_parallel_extrema_propagate_exceptions_with_index();
+    test_parallel_extrema_of_small_and_sequential_views_wrap_exceptions();
+    test_parallel_indices_where_matches_sequential_indices_where();
+    test_parallel_indices_where_of_split_and_sequential_views();
+    test_parallel_indices_where_propagates_exceptions_with_index();
+}
@@ -0,0 +1,185 @@
+#include "indexed_view_progress.hpp"
+#include <assert.h>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+void test_observed_view_yields_same_elements_as_plain_view() {
+    std::vector<int> v{3, 1, 4, 1, 5, 9, 2, 6};
+    jss::indexed_progress progress;
+    unsigned count= 0;
+    for(auto x : jss::observed_indexed_view<4>(v, progress)) {
+        assert(x.index == count);
+        assert(x.value == v[count]);
+        ++count;
+    }
+    assert(count == v.size());
+}
+
+void test_observed_view_allows_modification() {
+    std::vector<int> v(10, 2);
+    jss::indexed_progress progress;
+    for(auto x : jss::observed_indexed_view<3>(v, progress)) {
+        x.value*= static_cast<int>(x.index);
+    }
+    for(size_t i= 0; i < v.size(); ++i) {
+        assert(v[i] == static_cast<int>(2 * i));
+    }
+}
+
+void test_progress_is_published_every_interval() {
+    std::vector<int> v(10500);
+    jss::indexed_progress progress;
+    assert(progress.load() == 0);
+    for(auto x : jss::observed_indexed_view<1000>(v, progress)) {
+        assert(progress.load() == x.index - x.index % 1000);
+    }
+    assert(progress.load() == 10500);
+}
+
+void test_final_progress_is_published_at_end() {
+    std::list<int> l(7, 1);
+    jss::indexed_progress progress;
+    auto view= jss::observed_indexed_view<4>(l, progress);
+    auto it= view.begin();
+    for(unsigned i= 0; i < 5; ++i)
+        ++it;
+    assert(progress.load() == 4);
+    ++it;
+    ++it;
+    assert(progress.load() == 7);
+    assert(it == view.end());
+
+    jss::indexed_progress empty_progress;
+    std::vector<int> empty;
+    auto empty_view= jss::observed_indexed_view<4>(empty, empty_progress);
+    assert(empty_view.begin() == empty_view.end());
+    assert(empty_progress.load() == 0);
+}
+
+void test_observed_view_keeps_iterator_category() {
+    std::vector<int> v(100);
+    jss::indexed_progress progress;
+    auto view= jss::observed_indexed_view<16>(v, progress);
+    using iterator= decltype(view.begin());
+    static_assert(std::is_same<
+                  std::iterator_traits<iterator>::iterator_category,
+                  std::random_access_iterator_tag>::value);
+    assert(std::distance(view.begin(), view.end()) == 100);
+    auto it= view.begin() + 40;
+    assert(it->index == 40);
+    assert(it[2].index == 42);
+    assert(view.end() - it == 60);
+    assert(it < view.end());
+    assert(progress.load() == 0);
+
+    std::list<int> l(3);
+    auto list_view= jss::observed_indexed_view<16>(l, progress);
+    using list_iterator= decltype(list_view.begin());
+    using wrapped_iterator= decltype(jss::indexed_view(l).begin());
+    static_assert(std::is_same<
+                  std::iterator_traits<list_iterator>::iterator_category,
+                  std::iterator_traits<wrapped_iterator>::iterator_category>::
+                      value);
+}
+
+void test_observed_random_access_view_can_be_split() {
+    std::vector<int> v(100);
+    jss::indexed_progress progress;
+    auto view= jss::observed_indexed_view<10>(v, progress);
+    decltype(view) second(view, jss::split());
+    assert(std::distance(view.begin(), view.end()) == 50);
+    assert(second.begin()->index == 50);
+    for(auto x : second) {
+        x.value= 1;
+    }
+    assert(progress.load() == 100);
+    assert(v[49] == 0);
+    assert(v[50] == 1);
+    static_assert(decltype(view)::is_splittable_in_proportion);
+}
+
+void test_observed_view_works_with_non_random_access_and_owned_ranges() {
+    std::list<int> l{5, 6, 7, 8, 9};
+    jss::indexed_progress progress;
+    auto view= jss::observed_indexed_view<2>(l, progress);
+    auto it= view.begin();
+    assert(it->index == 0);
+    assert((*it++).value == 5);
+    assert(progress.load() == 0);
+    ++it;
+    assert(progress.load() == 2);
+    assert(it->value == 7);
+
+    jss::indexed_progress owned_progress;
+    unsigned count= 0;
+    for(auto x :
+        jss::observed_indexed_view<2>(std::vector<int>{1, 2, 3}, owned_progress)) {
+        assert(x.index == count);
+        assert(x.value == static_cast<int>(count + 1));
+        ++count;
+    }
+    assert(count == 3);
+    assert(owned_progress.load() == 3);
+}
+
+void test_disabled_observation_gives_plain_view() {
+    std::vector<int> v{1, 2, 3};
+    jss::indexed_progress progress;
+    static_assert(std::is_same<
+                  decltype(jss::observed_indexed_view<0>(v, progress)),
+                  decltype(jss::indexed_view(v))>::value);
+    for(auto x : jss::observed_indexed_view<0>(v, progress)) {
+        x.value= 0;
+    }
+    assert(progress.load() == 0);
+    assert(v[2] == 0);
+}
+
+void test_progress_counter_fills_a_cache_line() {
+    static_assert(alignof(jss::indexed_progress) == 64);
+    jss::indexed_progress counters[2];
+    assert(
+        reinterpret_cast<char *>(&counters[1]) -
+            reinterpret_cast<char *>(&counters[0]) ==
+        64);
+}
+
+void test_progress_can_be_monitored_from_another_thread() {
+    std::vector<unsigned> v(1 << 20, 1);
+    jss::indexed_progress progress;
+    std::atomic<bool> done(false);
+    std::thread worker([&] {
+        for(auto x : jss::observed_indexed_view<256>(v, progress)) {
+            x.value+= static_cast<unsigned>(x.index);
+        }
+        done.store(true);
+    });
+    size_t last= 0;
+    while(!done.load()) {
+        size_t const current= progress.load();
+        assert(current >= last);
+        assert(current <= v.size());
+        assert(!(current % 256));
+        last= current;
+        std::this_thread::yield();
+    }
+    worker.join();
+    assert(progress.load() == v.size());
+}
+
+int main() {
+    test_observed_view_yields_same_elements_as_plain_view();
+    test_observed_view_allows_modification();
+    test_progress_is_published_every_interval();
+    test_final_progress_is_published_at_end();
+    test_observed_view_keeps_iterator_category();
+    test_observed_random_access_view_can_be_split();
+    test_observed_view_works_with_non_random_access_and_owned_ranges();
+    test_disabled_observation_gives_plain_view();
+    test_progress_counter_fills_a_cache_line();
+    test_progress_can_be_monitored_from_another_thread();
+}
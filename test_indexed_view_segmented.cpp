@@ -0,0 +1,122 @@
+#include "indexed_view_segmented.hpp"
+#include <assert.h>
+#include <deque>
+#include <list>
+#include <vector>
+#include <utility>
+
+#ifdef __GLIBCXX__
+static_assert(
+    jss::segmented_iterator_traits<std::deque<int>::iterator>::is_segmented,
+    "deque iterators should be segmented");
+static_assert(
+    jss::segmented_iterator_traits<
+        std::deque<int>::const_iterator>::is_segmented,
+    "deque const_iterators should be segmented");
+#endif
+static_assert(
+    !jss::segmented_iterator_traits<std::vector<int>::iterator>::is_segmented,
+    "vector iterators are not segmented");
+
+void test_indexed_for_each_visits_deque_elements_in_order() {
+    std::deque<int> const d= {1, 45, 67, 98, 123, -45};
+
+    std::vector<std::pair<size_t, int const *>> output;
+    jss::indexed_for_each(jss::indexed_view(d.begin(), d.end()), [&](auto x) {
+        output.push_back({x.index, &x.value});
+    });
+
+    assert(output.size() == d.size());
+    for(size_t i= 0; i < output.size(); ++i) {
+        assert(output[i].first == i);
+        assert(output[i].second == &d[i]);
+    }
+}
+
+void test_indexed_for_each_crosses_deque_blocks() {
+    std::deque<int> d;
+    for(int i= 0; i < 10000; ++i) {
+        if(i % 2)
+            d.push_back(i);
+        else
+            d.push_front(-i);
+    }
+
+    jss::indexed_for_each(
+        jss::indexed_view(d), [](auto x) { x.value= static_cast<int>(x.index); });
+
+    for(size_t i= 0; i < d.size(); ++i) {
+        assert(d[i] == static_cast<int>(i));
+    }
+}
+
+void test_indexed_for_each_keeps_indices_of_split_views() {
+    std::deque<size_t> d(3000);
+    auto view= jss::indexed_view(d);
+    decltype(view) second(view, jss::proportional_split(1, 2));
+
+    jss::indexed_for_each(second, [](auto x) { x.value= x.index; });
+
+    for(size_t i= 0; i < d.size(); ++i) {
+        assert(d[i] == (i < 1000 ? 0 : i));
+    }
+}
+
+void test_indexed_for_each_works_for_non_segmented_ranges() {
+    std::list<int> l= {3, 4, 5};
+    std::vector<int> v= {6, 7, 8};
+
+    auto func= jss::indexed_for_each(
+        jss::indexed_view(l), [](auto x) { x.value+= static_cast<int>(x.index); });
+    jss::indexed_for_each(
+        jss::indexed_view(v), [](auto x) { x.value*= static_cast<int>(x.index); });
+    (void)func;
+
+    assert((l == std::list<int>{3, 5, 7}));
+    assert((v == std::vector<int>{0, 7, 16}));
+}
+
+void test_indexed_accumulate_sums_over_deque_in_order() {
+    std::deque<long> d;
+    for(long i= 0; i < 5000; ++i) {
+        d.push_back(i % 7);
+    }
+
+    long expected= 0;
+    for(size_t i= 0; i < d.size(); ++i) {
+        expected+= d[i] * static_cast<long>(i);
+    }
+
+    long const result= jss::indexed_accumulate(
+        jss::indexed_view(d), 0L,
+        [](long sum, auto x) { return sum + x.value * static_cast<long>(x.index); });
+    assert(result == expected);
+
+    std::vector<size_t> order= jss::indexed_accumulate(
+        jss::indexed_view_n(d.begin(), 600), std::vector<size_t>(),
+        [](std::vector<size_t> indices, auto x) {
+            indices.push_back(x.index);
+            return indices;
+        });
+    assert(order.size() == 600);
+    for(size_t i= 0; i < order.size(); ++i) {
+        assert(order[i] == i);
+    }
+}
+
+void test_indexed_accumulate_on_empty_deque_returns_init() {
+    std::deque<int> d;
+
+    assert(
+        jss::indexed_accumulate(
+            jss::indexed_view(d), 42, [](int, auto) { return 0; }) == 42);
+}
+
+int main() {
+    test_indexed_for_each_visits_deque_elements_in_order();
+    test_indexed_for_each_crosses_deque_blocks();
+    test_indexed_for_each_keeps_indices_of_split_views();
+    test_indexed_for_each_works_for_non_segmented_ranges();
+    test_indexed_accumulate_sums_over_deque_in_order();
+    test_indexed_accumulate_on_empty_deque_returns_init();
+}
@@ -0,0 +1,278 @@
+#include "indexed_view_text.hpp"
+#include <assert.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct code_point {
+    size_t index;
+    size_t byte_offset;
+    char32_t value;
+
+    friend bool operator==(code_point const &lhs, code_point const &rhs) {
+        return lhs.index == rhs.index && lhs.byte_offset == rhs.byte_offset &&
+               lhs.value == rhs.value;
+    }
+};
+
+std::vector<code_point> collect(jss::utf8_indexed_view const &view) {
+    std::vector<code_point> output;
+    for(auto x : view) {
+        output.push_back({x.index, x.byte_offset, x.value});
+    }
+    return output;
+}
+
+void test_utf8_view_yields_index_offset_and_code_point() {
+    std::string const text= "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z";
+
+    auto output= collect(jss::utf8_indexed_view(text));
+
+    assert(
+        (output == std::vector<code_point>{
+                       {0, 0, U'a'},
+                       {1, 1, U'é'},
+                       {2, 3, U'€'},
+                       {3, 6, U'\U0001f600'},
+                       {4, 10, U'z'}}));
+    assert(jss::utf8_indexed_view(text).size() == 5);
+}
+
+void test_utf8_view_of_empty_text_is_empty() {
+    jss::utf8_indexed_view view("");
+
+    assert(view.begin() == view.end());
+    assert(view.empty());
+    assert(view.size() == 0);
+}
+
+void test_utf8_view_handles_long_ascii_runs() {
+    std::string text(100, 'x');
+    text+= "\xc3\xa9";
+    text+= std::string(40, 'y');
+
+    size_t count= 0;
+    for(auto x : jss::utf8_indexed_view(text)) {
+        assert(x.index == count);
+        if(count < 100) {
+            assert(x.byte_offset == count);
+            assert(x.value == U'x');
+        } else if(count == 100) {
+            assert(x.byte_offset == 100);
+            assert(x.value == U'é');
+        } else {
+            assert(x.byte_offset == count + 1);
+            assert(x.value == U'y');
+        }
+        ++count;
+    }
+    assert(count == 141);
+    assert(jss::utf8_indexed_view(text).size() == 141);
+}
+
+void test_utf8_view_replaces_invalid_bytes() {
+    std::string const text=
+        "\x80"
+        "a\xc0\xaf"
+        "\xe2\x82"
+        "b\xed\xa0\x80\xf4\x90\x80\x80";
+
+    auto output= collect(jss::utf8_indexed_view(text));
+
+    std::vector<char32_t> values;
+    for(auto const &entry : output) {
+        values.push_back(entry.value);
+    }
+    char32_t const r= 0xfffd;
+    assert(
+        (values == std::vector<char32_t>{
+                       r, U'a', r, r, r, r, U'b', r, r, r, r, r, r, r}));
+    assert(output.size() == text.size());
+    assert(jss::utf8_indexed_view(text).size() == output.size());
+}
+
+std::string mixed_text(size_t count) {
+    std::string text;
+    char const *const pieces[]= {"a", "\xc3\xa9", "bcd", "\xe2\x82\xac",
+                                 "\xf0\x9f\x98\x80"};
+    for(size_t i= 0; i < count; ++i) {
+        text+= pieces[(i * 7) % 5];
+    }
+    return text;
+}
+
+void test_utf8_seek_without_index() {
+    std::string const text= mixed_text(300);
+    jss::utf8_indexed_view view(text);
+    auto const all= collect(view);
+
+    for(size_t k : {size_t(0), size_t(1), size_t(17), all.size() - 1}) {
+        auto it= view.seek(k);
+        assert(it != view.end());
+        assert(it->index == k);
+        assert(it->byte_offset == all[k].byte_offset);
+        assert(it->value == all[k].value);
+    }
+    assert(view.seek(all.size()) == view.end());
+    assert(view.seek(all.size() + 100) == view.end());
+}
+
+void test_utf8_seek_with_index() {
+    std::string const text= mixed_text(1000);
+    jss::utf8_seek_index index(text, 16);
+    jss::utf8_indexed_view view(text, index);
+    auto const all= collect(jss::utf8_indexed_view(text));
+
+    assert(index.size() == all.size());
+    assert(index.get_stride() == 16);
+    assert(view.size() == all.size());
+    for(size_t k= 0; k < all.size(); k+= 13) {
+        auto it= view.seek(k);
+        assert(it->index == k);
+        assert(it->byte_offset == all[k].byte_offset);
+        assert(it->value == all[k].value);
+    }
+    auto it= view.seek(all.size() - 5);
+    size_t count= 0;
+    for(; it != view.end(); ++it) {
+        assert(it->index == all.size() - 5 + count);
+        ++count;
+    }
+    assert(count == 5);
+    assert(view.seek(all.size()) == view.end());
+}
+
+std::vector<std::string_view> collect_lines(std::string_view buffer) {
+    std::vector<std::string_view> output;
+    for(auto x : jss::indexed_lines(buffer)) {
+        assert(x.index == output.size());
+        output.push_back(x.value);
+    }
+    return output;
+}
+
+void test_indexed_lines_splits_buffer_into_lines() {
+    std::string const buffer= "first\nsecond\nthird\n";
+
+    auto lines= collect_lines(buffer);
+
+    assert(
+        (lines == std::vector<std::string_view>{"first", "second", "third"}));
+    assert(lines[1].data() == buffer.data() + 6);
+}
+
+void test_indexed_lines_strips_carriage_returns() {
+    assert(
+        (collect_lines("a\r\nb\nc\r\n") ==
+         std::vector<std::string_view>{"a", "b", "c"}));
+    assert(
+        (collect_lines("\r\n\r\rx\r\n") ==
+         std::vector<std::string_view>{"", "\r\rx"}));
+}
+
+void test_indexed_lines_includes_final_unterminated_line() {
+    assert(
+        (collect_lines("one\ntwo") ==
+         std::vector<std::string_view>{"one", "two"}));
+    assert((collect_lines("only") == std::vector<std::string_view>{"only"}));
+}
+
+void test_indexed_lines_preserves_empty_lines() {
+    assert(collect_lines("").empty());
+    assert((collect_lines("\n") == std::vector<std::string_view>{""}));
+    assert(
+        (collect_lines("\n\nx\n\n") ==
+         std::vector<std::string_view>{"", "", "x", ""}));
+}
+
+void test_indexed_lines_handles_long_lines() {
+    std::string buffer;
+    for(size_t i= 0; i < 50; ++i) {
+        buffer+= std::string(i * 13, static_cast<char>('a' + i % 26));
+        buffer+= (i % 2) ? "\r\n" : "\n";
+    }
+
+    auto lines= collect_lines(buffer);
+
+    assert(lines.size() == 50);
+    for(size_t i= 0; i < lines.size(); ++i) {
+        assert(lines[i] == std::string(i * 13, static_cast<char>('a' + i % 26)));
+    }
+}
+
+void test_indexed_lines_iterator_operations() {
+    auto view= jss::indexed_lines("a\nb");
+
+    auto it= view.begin();
+    assert(it->value == "a");
+    assert((*it++).index == 0);
+    auto it2= it;
+    assert(it2 == it);
+    assert(it2->index == 1);
+    assert(it2->value == "b");
+    ++it2;
+    assert(it2 == view.end());
+}
+
+void test_utf8_view_can_resume_from_checkpoint() {
+    std::string text= "a\u00e9b\u20acc\U0001f600d";
+    jss::utf8_indexed_view view(text);
+    auto it= view.begin();
+    ++it;
+    ++it;
+    ++it;
+    auto checkpoint= it.checkpoint();
+    assert(checkpoint.index == 3);
+    assert(checkpoint.offset == 4);
+
+    auto resumed= view.resume(checkpoint);
+    assert(resumed == it);
+    assert(resumed->index == 3);
+    assert(resumed->byte_offset == 4);
+    assert(resumed->value == U'\u20ac');
+    for(unsigned i= 0; i < 4; ++i)
+        ++resumed;
+    assert(resumed == view.end());
+    assert(view.resume(jss::indexed_checkpoint{7, text.size()}) == view.end());
+}
+
+void test_indexed_lines_can_resume_from_checkpoint() {
+    std::string_view buffer= "first\r\nsecond\n\nfourth\nfifth";
+    auto view= jss::indexed_lines(buffer);
+    auto it= view.begin();
+    ++it;
+    ++it;
+    ++it;
+    auto checkpoint= it.checkpoint();
+    assert(checkpoint.index == 3);
+    assert(checkpoint.offset == 15);
+
+    auto resumed= view.resume(checkpoint);
+    assert(resumed == it);
+    assert(resumed->index == 3);
+    assert(resumed->value == "fourth");
+    ++resumed;
+    assert(resumed->index == 4);
+    assert(resumed->value == "fifth");
+    assert(resumed.checkpoint().offset == 22);
+    ++resumed;
+    assert(resumed == view.end());
+    assert(view.resume(jss::indexed_checkpoint{5, 27}) == view.end());
+}
+
+int main() {
+    test_utf8_view_yields_index_offset_and_code_point();
+    test_utf8_view_of_empty_text_is_empty();
+    test_utf8_view_handles_long_ascii_runs();
+    test_utf8_view_replaces_invalid_bytes();
+    test_utf8_seek_without_index();
+    test_utf8_seek_with_index();
+    test_indexed_lines_splits_buffer_into_lines();
+    test_indexed_lines_strips_carriage_returns();
+    test_indexed_lines_includes_final_unterminated_line();
+    test_indexed_lines_preserves_empty_lines();
+    test_indexed_lines_handles_long_lines();
+    test_indexed_lines_iterator_operations();
+    test_utf8_view_can_resume_from_checkpoint();
+    test_indexed_lines_can_resume_from_checkpoint();
+}
@@ -0,0 +1,138 @@
+#include "indexed_view_varint.hpp"
+#include <assert.h>
+#include <stdint.h>
+#include <vector>
+
+std::vector<uint64_t> make_values(size_t count) {
+    std::vector<uint64_t> values;
+    uint64_t value= 0;
+    for(size_t i= 0; i < count; ++i) {
+        // Mostly small deltas, with occasional large ones
+        value+= (i % 50 == 49) ? (uint64_t(1) << (i % 60)) : (i % 7);
+        values.push_back(value);
+    }
+    return values;
+}
+
+void test_encoding_uses_one_byte_for_small_deltas() {
+    std::vector<unsigned> values{3, 5, 5, 133, 201};
+    auto encoded= jss::delta_varint_encode(values);
+    std::vector<uint8_t> expected{3, 2, 0, 0x80, 0x01, 68};
+    assert(encoded == expected);
+}
+
+void test_decoding_view_yields_indices_and_values() {
+    auto values= make_values(1000);
+    auto encoded= jss::delta_varint_encode(values);
+    jss::delta_varint_view view(encoded.data(), encoded.size());
+
+    assert(view.size() == values.size());
+    size_t count= 0;
+    for(auto x : view) {
+        assert(x.index == count);
+        assert(x.value == values[count]);
+        ++count;
+    }
+    assert(count == values.size());
+}
+
+void test_decoding_groups_of_single_byte_deltas() {
+    std::vector<uint64_t> values;
+    for(uint64_t i= 0; i < 100; ++i) {
+        values.push_back(i * 127 + 1000000);
+    }
+    auto encoded= jss::delta_varint_encode(values);
+    jss::delta_varint_view view(encoded.data(), encoded.size());
+
+    size_t count= 0;
+    for(auto x : view) {
+        assert(x.index == count);
+        assert(x.value == values[count]);
+        ++count;
+    }
+    assert(count == values.size());
+}
+
+void test_decreasing_and_large_values_round_trip() {
+    std::vector<uint64_t> values{
+        ~uint64_t(0), 0, uint64_t(1) << 63, 5, 4, 3, ~uint64_t(0) - 1};
+    auto encoded= jss::delta_varint_encode(values);
+    jss::delta_varint_view view(encoded.data(), encoded.size());
+
+    size_t count= 0;
+    for(auto x : view) {
+        assert(x.value == values[x.index]);
+        ++count;
+    }
+    assert(count == values.size());
+}
+
+void test_empty_stream_gives_empty_view() {
+    std::vector<uint8_t> encoded;
+    jss::delta_varint_view view(encoded.data(), encoded.size());
+    assert(view.empty());
+    assert(view.begin() == view.end());
+}
+
+void test_can_seek_with_and_without_skip_index() {
+    auto values= make_values(1000);
+    auto encoded= jss::delta_varint_encode(values);
+    jss::varint_skip_index skip(encoded.data(), encoded.size(), 64);
+    assert(skip.size() == values.size());
+
+    jss::delta_varint_view plain(encoded.data(), encoded.size());
+    jss::delta_varint_view indexed(encoded.data(), encoded.size(), skip);
+
+    for(size_t k : {size_t(0), size_t(1), size_t(15), size_t(16), size_t(63),
+                    size_t(64), size_t(65), size_t(500), size_t(999)}) {
+        auto it= indexed.seek(k);
+        assert(it->index == k);
+        assert(it->value == values[k]);
+        auto it2= plain.seek(k);
+        assert(it2->index == k);
+        assert(it2->value == values[k]);
+
+        size_t count= k;
+        for(; it != indexed.end(); ++it) {
+            assert(it->index == count);
+            assert(it->value == values[count]);
+            ++count;
+        }
+        assert(count == values.size());
+    }
+    assert(indexed.seek(values.size()) == indexed.end());
+}
+
+void test_can_resume_from_checkpoint() {
+    auto values= make_values(500);
+    auto encoded= jss::delta_varint_encode(values);
+    jss::varint_skip_index skip(encoded.data(), encoded.size(), 32);
+    jss::delta_varint_view view(encoded.data(), encoded.size(), skip);
+
+    auto it= view.begin();
+    for(size_t i= 0; i < 77; ++i)
+        ++it;
+    auto checkpoint= it.checkpoint();
+    assert(checkpoint.index == 77);
+
+    auto resumed= view.resume(checkpoint);
+    assert(resumed == it);
+    size_t count= 77;
+    for(; resumed != view.end(); ++resumed) {
+        assert(resumed->index == count);
+        assert(resumed->value == values[count]);
+        ++count;
+    }
+    assert(count == values.size());
+    assert(view.resume(jss::indexed_checkpoint{500, 0}) == view.end());
+}
+
+int main() {
+    test_encoding_uses_one_byte_for_small_deltas();
+    test_decoding_view_yields_indices_and_values();
+    test_decoding_groups_of_single_byte_deltas();
+    test_decreasing_and_large_values_round_trip();
+    test_empty_stream_gives_empty_view();
+    test_can_seek_with_and_without_skip_index();
+    test_can_resume_from_checkpoint();
+}
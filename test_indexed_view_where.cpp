@@ -0,0 +1,178 @@
+#include "indexed_view_where.hpp"
+#include <assert.h>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/// The indices of the elements that match pred, found with a plain loop
+template <typename T, typename Predicate>
+std::vector<size_t>
+reference_indices(std::vector<T> const &values, Predicate pred) {
+    std::vector<size_t> indices;
+    for(size_t i= 0; i < values.size(); ++i) {
+        if(pred(values[i]))
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+/// Find the indices with indices_where into a buffer of exactly the right
+/// size
+template <typename View, typename Predicate>
+std::vector<size_t> exact_indices_where(View &&view, Predicate pred) {
+    std::vector<size_t> indices(jss::count_where(view, pred));
+    size_t *const end= jss::indices_where(view, pred, indices.data());
+    assert(end == indices.data() + indices.size());
+    return indices;
+}
+
+void test_indices_where_matches_reference_for_all_densities() {
+    size_t const sizes[]= {0, 1, 3, 63, 64, 65, 127, 128, 200, 1000, 4099};
+    unsigned const thresholds[]= {0, 1, 8, 64, 128, 200, 255, 256};
+    for(size_t size : sizes) {
+        std::vector<unsigned char> values(size);
+        uint32_t state= static_cast<uint32_t>(size) + 1;
+        for(auto &value : values) {
+            state= state * 1664525u + 1013904223u;
+            value= static_cast<unsigned char>(state >> 24);
+        }
+        for(unsigned threshold : thresholds) {
+            auto const expected= reference_indices(
+                values, [&](unsigned char v) { return v < threshold; });
+            assert(
+                exact_indices_where(
+                    jss::indexed_view(values),
+                    [&](auto x) { return x.value < threshold; }) == expected);
+        }
+    }
+}
+
+void test_indices_where_works_for_arithmetic_types() {
+    std::vector<float> f;
+    std::vector<long long> ll;
+    for(int i= 0; i < 500; ++i) {
+        f.push_back(static_cast<float>((i * 37) % 101) - 50.0f);
+        ll.push_back((i * 53) % 97);
+    }
+    assert(
+        exact_indices_where(
+            jss::indexed_view(f), [](auto x) { return x.value > 0.0f; }) ==
+        reference_indices(f, [](float v) { return v > 0.0f; }));
+    assert(
+        exact_indices_where(
+            jss::indexed_view(ll), [](auto x) { return x.value % 3 == 0; }) ==
+        reference_indices(ll, [](long long v) { return v % 3 == 0; }));
+}
+
+void test_indices_where_does_not_write_past_the_matches() {
+    std::vector<int> v(256, 1);
+    v[3]= -1;
+    v[130]= -1;
+    size_t buffer[5]= {99, 99, 99, 99, 99};
+    size_t *const end= jss::indices_where(
+        jss::indexed_view(v), [](auto x) { return x.value < 0; }, buffer + 1);
+    assert(end == buffer + 3);
+    assert(buffer[0] == 99);
+    assert(buffer[1] == 3);
+    assert(buffer[2] == 130);
+    assert(buffer[3] == 99);
+    assert(buffer[4] == 99);
+
+    std::vector<int> all(100, 1);
+    std::vector<size_t> indices(100 + 1, 99);
+    assert(
+        jss::indices_where(
+            jss::indexed_view(all), [](auto) { return true; },
+            indices.data()) == indices.data() + 100);
+    for(size_t i= 0; i < 100; ++i) {
+        assert(indices[i] == i);
+    }
+    assert(indices[100] == 99);
+}
+
+void test_indices_where_uses_view_indices() {
+    std::vector<int> v(300);
+    for(size_t i= 0; i < v.size(); ++i) {
+        v[i]= static_cast<int>(i % 10);
+    }
+    auto view= jss::indexed_view(v);
+    decltype(view) second(view, jss::split());
+    auto const zeros=
+        exact_indices_where(second, [](auto x) { return x.value == 0; });
+    assert(zeros.size() == 15);
+    for(size_t i= 0; i < zeros.size(); ++i) {
+        assert(zeros[i] == 150 + i * 10);
+    }
+
+    auto const odd_indices=
+        exact_indices_where(jss::indexed_view(v), [](auto x) {
+            return x.index % 2 == 1;
+        });
+    assert(odd_indices.size() == 150);
+    assert(odd_indices[0] == 1);
+    assert(odd_indices[149] == 299);
+
+    int const array[]= {5, -1, 3, -2, 7};
+    assert(
+        exact_indices_where(
+            jss::indexed_view_n(array, 4),
+            [](auto x) { return x.value < 0; }) ==
+        (std::vector<size_t>{1, 3}));
+}
+
+void test_indices_where_of_non_contiguous_ranges_and_output_iterators() {
+    std::list<int> l{3, -1, 4, -1, 5, -9};
+    assert(
+        exact_indices_where(
+            jss::indexed_view(l), [](auto x) { return x.value < 0; }) ==
+        (std::vector<size_t>{1, 3, 5}));
+
+    std::vector<std::string> words{"pear", "", "fig", ""};
+    std::vector<size_t> empty_words;
+    jss::indices_where(
+        jss::indexed_view(words), [](auto x) { return x.value.empty(); },
+        std::back_inserter(empty_words));
+    assert(empty_words == (std::vector<size_t>{1, 3}));
+
+    std::vector<int> v{0, 1, 0, 1};
+    std::list<size_t> ones;
+    jss::indices_where(
+        jss::indexed_view(v), [](auto x) { return x.value == 1; },
+        std::back_inserter(ones));
+    assert(ones == (std::list<size_t>{1, 3}));
+}
+
+void test_indices_where_lets_exceptions_propagate_unchanged() {
+    std::vector<int> v(200, 1);
+    v[150]= -1;
+    auto const pred= [](auto x) {
+        if(x.value < 0)
+            throw std::runtime_error("negative");
+        return x.value > 1;
+    };
+    std::vector<size_t> indices(v.size());
+    unsigned caught= 0;
+    try {
+        jss::indices_where(jss::indexed_view(v), pred, indices.data());
+    } catch(std::runtime_error const &) {
+        ++caught;
+    }
+    try {
+        jss::count_where(jss::indexed_view(v), pred);
+    } catch(std::runtime_error const &) {
+        ++caught;
+    }
+    assert(caught == 2);
+}
+
+int main() {
+    test_indices_where_matches_reference_for_all_densities();
+    test_indices_where_works_for_arithmetic_types();
+    test_indices_where_does_not_write_past_the_matches();
+    test_indices_where_uses_view_indices();
+    test_indices_where_of_non_contiguous_ranges_and_output_iterators();
+    test_indices_where_lets_exceptions_propagate_unchanged();
+}